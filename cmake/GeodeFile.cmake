@@ -68,6 +68,11 @@ function(create_geode_file proname)
     set(options DONT_INSTALL)
     cmake_parse_arguments(CREATE_GEODE_FILE "${options}" "" "" ${ARGN})
 
+    # use the precompiled header shared by all mods (GEODE_SHARED_PCH)
+    if (TARGET geode-pch)
+        target_precompile_headers(${proname} REUSE_FROM geode-pch)
+    endif()
+
     if (GEODE_DISABLE_CLI_CALLS)
         message("Skipping creating geode file for ${proname}")
         return()
@@ -88,6 +93,14 @@ function(create_geode_file proname)
         COMMAND ${GEODE_CLI} package get-id ${CMAKE_CURRENT_SOURCE_DIR} --raw
         OUTPUT_VARIABLE MOD_ID
     )
+    string(STRIP "${MOD_ID}" MOD_ID)
+
+    # lets "name"_spr be expanded at compile time. Not for mods sharing the
+    # precompiled header: it's built without the define, and since it tests
+    # for it the compiler would throw the header away
+    if (NOT TARGET geode-pch)
+        target_compile_definitions(${proname} PRIVATE GEODE_MOD_ID="${MOD_ID}")
+    endif()
 
     if (CREATE_GEODE_FILE_DONT_INSTALL)
         set(INSTALL_ARG "")
@@ -2,6 +2,7 @@
 #include <vector>
 #include <variant>
 #include <map>
+#include <unordered_map>
 #include <algorithm>
 #include <iostream>
 
@@ -124,9 +125,19 @@ struct Class {
 
 struct Root {
 	std::vector<Class> classes;
+	// index of each class in classes by name, kept up to date by the parser
+	std::unordered_map<std::string, size_t> class_indices;
 
 	inline Class* operator[](std::string const& name) {
-		auto it = std::find_if(classes.begin(), classes.end(), [name](Class& cls) {
+		auto found = class_indices.find(name);
+		if (found != class_indices.end() && found->second < classes.size() && classes[found->second].name == name)
+			return &classes[found->second];
+
+		// the index is complete unless classes were added after parsing
+		if (class_indices.size() == classes.size())
+			return nullptr;
+
+		auto it = std::find_if(classes.begin(), classes.end(), [&name](Class& cls) {
 		        return cls.name == name;
 		});
 
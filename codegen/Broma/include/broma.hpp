@@ -2,4 +2,10 @@
 
 namespace broma {
 	Root parse_file(std::string const& fname);
+	/**
+	 * Parse bindings that are already in memory. Includes are still read
+	 * from files
+	 * @param name What errors call the source
+	 */
+	Root parse_string(std::string const& source, std::string const& name);
 }
\ No newline at end of file
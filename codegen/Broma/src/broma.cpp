@@ -33,15 +33,14 @@ namespace broma {
 		}
 	};
 
-	struct field : sor<inline_expr, pad_expr, member_expr, bind_expr, ool_expr> {};
+	struct field : sor<inline_expr, pad_expr, member_expr, function_expr> {};
 
 	template <>
 	struct run_action<field> {
 		template <typename T>
 		static void apply(T& input, Root* root, ScratchData* scratch) {
 			scratch->wip_field.parent = scratch->wip_class.name;
-			static size_t index = 0;
-			scratch->wip_field.field_id = index++;
+			scratch->wip_field.field_id = scratch->field_index++;
 			scratch->wip_class.fields.push_back(scratch->wip_field);
 		}
 	};
@@ -87,7 +86,7 @@ namespace broma {
 		static void apply(T& input, Root* root, ScratchData* scratch) {
 			scratch->wip_class.name = input.string();
 
-			if (std::find(root->classes.begin(), root->classes.end(), input.string()) != root->classes.end()) {
+			if (root->class_indices.count(input.string())) {
 				scratch->errors.push_back(parse_error("Class duplicate!", input.position()));
 			}
 		}
@@ -98,19 +97,19 @@ namespace broma {
 	struct run_action<class_statement> {
 		template <typename T>
 		static void apply(T& input, Root* root, ScratchData* scratch) {
+			root->class_indices.try_emplace(scratch->wip_class.name, root->classes.size());
 			root->classes.push_back(std::move(scratch->wip_class));
 			//std::cout << "class end\n";
 			scratch->wip_class = Class();
+			scratch->wip_signatures.clear();
 		}
 	};
 
 	struct root_grammar : until<eof, sep, must<sor<include_expr, class_statement>>, sep> {};
 
-	Root parse_file(std::string const& fname) {
-		file_input<> input(fname);
-
+	template <typename Input>
+	Root parse_input(Input& input, ScratchData& scratch) {
 		Root root;
-		ScratchData scratch;
 		parse<must<root_grammar>, run_action>(input, &root, &scratch);
 		post_process(root);
 
@@ -126,4 +125,19 @@ namespace broma {
 
 		return root;
 	}
+
+	Root parse_file(std::string const& fname) {
+		file_input<> input(fname);
+
+		ScratchData scratch;
+		scratch.included.insert(std::filesystem::weakly_canonical(fname));
+		return parse_input(input, scratch);
+	}
+
+	Root parse_string(std::string const& source, std::string const& name) {
+		memory_input<> input(source, name);
+
+		ScratchData scratch;
+		return parse_input(input, scratch);
+	}
 } // namespace broma
@@ -47,12 +47,15 @@ namespace broma {
 	struct run_action<function_begin> {
 		template <typename T>
 		static void apply(T& input, Root* root, ScratchData* scratch) {
-			for (auto& f : scratch->wip_class.fields) {
-				if (auto fn = f.get_fn()) {
-					if (*fn == scratch->wip_fn_begin) {
-						scratch->errors.push_back(parse_error("Function duplicate!", input.position()));
-					}
-				}
+			// what FunctionBegin::operator== compares
+			auto& fn = scratch->wip_fn_begin;
+			std::string signature = fn.name + (fn.is_const ? " const(" : "(");
+			for (auto& [type, name] : fn.args) {
+				signature += type.name + ",";
+			}
+
+			if (!scratch->wip_signatures.insert(std::move(signature)).second) {
+				scratch->errors.push_back(parse_error("Function duplicate!", input.position()));
 			}
 		}
 	};
@@ -124,7 +127,7 @@ namespace broma {
 		}
 	};
 
-	struct ool_expr : seq<function_begin, sep, tagged_rule<ool_expr, brace_start>> {};
+	struct ool_expr : seq<tagged_rule<ool_expr, brace_start>> {};
 
 	template <>
 	struct run_action<tagged_rule<ool_expr, brace_start>> {
@@ -137,7 +140,7 @@ namespace broma {
 		}
 	};
 
-	struct bind_expr : seq<function_begin, sep, bind> {};
+	struct bind_expr : seq<bind> {};
 
 	template <>
 	struct run_action<bind_expr> {
@@ -149,4 +152,8 @@ namespace broma {
 			scratch->wip_field.inner = f;
 		}
 	};
+
+	// bound and out of line functions begin the same way, so the beginning is
+	// only parsed once for both
+	struct function_expr : seq<function_begin, sep, sor<bind_expr, ool_expr>> {};
 } // namespace broma
\ No newline at end of file
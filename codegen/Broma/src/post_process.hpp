@@ -5,21 +5,31 @@
 #include <iostream>
 
 namespace broma {
-    inline void sortClass(Class cls, Root& root, std::vector<Class>& output) {
-        root.classes.erase(std::remove(root.classes.begin(), root.classes.end(), cls), root.classes.end());
-        for (auto name : cls.depends) {
-            if (root[name])
-                sortClass(*root[name], root, output);
+    // depth first, so every class comes after the ones it depends on
+    inline void sortClass(size_t index, Root& root, std::vector<bool>& visited, std::vector<Class>& output) {
+        visited[index] = true;
+        for (auto& name : root.classes[index].depends) {
+            auto dep = root.class_indices.find(name);
+            if (dep != root.class_indices.end() && !visited[dep->second])
+                sortClass(dep->second, root, visited, output);
         }
-        output.push_back(cls);
+        output.push_back(std::move(root.classes[index]));
     }
 
     inline void post_process(Root& root) {
         std::vector<Class> out;
+        out.reserve(root.classes.size());
+        std::vector<bool> visited(root.classes.size());
 
-        while (root.classes.size())
-            sortClass(root.classes[0], root, out);
+        for (size_t i = 0; i < root.classes.size(); ++i) {
+            // duplicates of a class are dropped, only the first one is indexed
+            if (!visited[i] && root.class_indices[root.classes[i].name] == i)
+                sortClass(i, root, visited, out);
+        }
 
-        root.classes = out;
+        root.classes = std::move(out);
+        root.class_indices.clear();
+        for (size_t i = 0; i < root.classes.size(); ++i)
+            root.class_indices[root.classes[i].name] = i;
     }
-}
\ No newline at end of file
+}
@@ -1,5 +1,6 @@
 #include "basic_components.hpp"
 #include "state.hpp"
+#include <filesystem>
 
 namespace broma {
 	struct include_name : until<at<one<'>'>>> {};
@@ -12,6 +13,11 @@ namespace broma {
 	struct run_action<include_name> {
 		template <typename T>
 		static void apply(T& input, Root* root, ScratchData* scratch) {
+			// every file is only parsed once, which also stops files that
+			// include each other from recursing forever
+			if (!scratch->included.insert(std::filesystem::weakly_canonical(input.string())).second)
+				return;
+
 			file_input<> file_input(input.string());
 
 			parse<root_grammar, broma::run_action>(file_input, root, scratch);
@@ -2,6 +2,10 @@
 
 #include <tao/pegtl.hpp>
 #include <ast.hpp>
+#include <filesystem>
+#include <set>
+#include <string>
+#include <unordered_set>
 
 namespace broma {
 	template <typename Rule>
@@ -14,6 +18,12 @@ namespace broma {
 		Platform wip_bind_platform;
 		Type wip_type;
 		FunctionBegin wip_fn_begin;
+		// signatures of the functions in wip_class, so finding duplicates
+		// doesn't compare every function to all the ones before it
+		std::unordered_set<std::string> wip_signatures;
+		// ids of fields are unique across all of the included files
+		size_t field_index = 0;
+		std::set<std::filesystem::path> included;
 
 		std::vector<tao::pegtl::parse_error> errors;
 	};
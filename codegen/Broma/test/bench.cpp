@@ -0,0 +1,152 @@
+// Measures how fast Broma parses, on generated files with the kinds of
+// fields the bindings have.
+// Usage: broma-bench [class count...] [--fields <per class>] [--big <fields>]
+//
+// Every size is parsed on its own, so the throughput of each can be compared
+// to see whether parsing stays linear as the bindings grow. --big also
+// parses a single class with that many functions, which is where per-class
+// work shows up
+
+#include <broma.hpp>
+
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+static char const* TYPES[] = {
+	"int", "float", "bool", "gd::string", "cocos2d::CCPoint", "cocos2d::CCNode*",
+	"cocos2d::CCArray*", "unsigned int", "GJGameLevel*", "cocos2d::ccColor3B const&",
+};
+
+static std::string type(std::mt19937& rng) {
+	return TYPES[rng() % std::size(TYPES)];
+}
+
+static std::string hex(std::mt19937& rng) {
+	char buffer[16];
+	std::snprintf(buffer, sizeof(buffer), "0x%x", static_cast<unsigned>(rng() % 0x400000));
+	return buffer;
+}
+
+static std::string args(std::mt19937& rng) {
+	std::string ret;
+	auto count = rng() % 5;
+	for (size_t i = 0; i < count; i++) {
+		if (i) ret += ", ";
+		ret += type(rng);
+		if (rng() % 2) ret += " arg" + std::to_string(i);
+	}
+	return ret;
+}
+
+static void writeClass(std::string& out, std::mt19937& rng, size_t index, size_t fields) {
+	auto name = "BenchClass" + std::to_string(index);
+	if (rng() % 4 == 0) {
+		out += "[[docs(\"Generated class for parsing benchmarks\")]]\n";
+	}
+	out += "class " + name;
+	if (index > 0) {
+		out += " : BenchClass" + std::to_string(rng() % index);
+	}
+	out += " {\n";
+	for (size_t i = 0; i < fields; i++) {
+		auto fn = "function" + std::to_string(i);
+		switch (rng() % 8) {
+			case 0:
+				out += "    " + type(rng) + " m_member" + std::to_string(i) + ";\n";
+				break;
+			case 1:
+				out += "    PAD = win " + hex(rng) + ", android " + hex(rng) + ";\n";
+				break;
+			case 2:
+				out += "    inline " + type(rng) + " " + fn + "() {\n        return {};\n    }\n";
+				break;
+			case 3:
+				out += "    " + type(rng) + " " + fn + "(" + args(rng) + ") {\n"
+					   "        // out of line\n        return {};\n    }\n";
+				break;
+			case 4:
+				out += "    static " + type(rng) + " " + fn + "(" + args(rng) + ") = mac " +
+					hex(rng) + ", win " + hex(rng) + ";\n";
+				break;
+			default:
+				out += "    virtual " + type(rng) + " " + fn + "(" + args(rng) + ")" +
+					(rng() % 3 ? "" : " const") + " = mac " + hex(rng) + ", win " + hex(rng) +
+					", ios " + hex(rng) + ";\n";
+				break;
+		}
+	}
+	out += "}\n\n";
+}
+
+struct Result {
+	size_t bytes;
+	double seconds;
+};
+
+static Result bench(std::filesystem::path const& dir, std::string const& source) {
+	auto file = dir / "Bench.bro";
+	std::ofstream(file, std::ios::binary) << source;
+
+	auto start = std::chrono::steady_clock::now();
+	auto root = broma::parse_file(file.string());
+	auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	if (root.classes.empty()) {
+		std::cerr << "nothing was parsed" << std::endl;
+		std::exit(EXIT_FAILURE);
+	}
+	return { source.size(), seconds };
+}
+
+static void print(std::string const& name, size_t units, char const* unit, Result result) {
+	std::cout << name << ": " << result.seconds * 1000 << " ms, "
+			  << result.bytes / result.seconds / (1 << 20) << " MB/s, "
+			  << units / result.seconds << " " << unit << "/s" << std::endl;
+}
+
+int main(int argc, char** argv) {
+	std::vector<size_t> counts;
+	size_t fields = 12;
+	size_t big = 0;
+	for (int i = 1; i < argc; i++) {
+		std::string arg = argv[i];
+		if (arg == "--fields" && i + 1 < argc) {
+			fields = std::strtoull(argv[++i], nullptr, 10);
+		}
+		else if (arg == "--big" && i + 1 < argc) {
+			big = std::strtoull(argv[++i], nullptr, 10);
+		}
+		else {
+			counts.push_back(std::strtoull(arg.c_str(), nullptr, 10));
+		}
+	}
+	if (counts.empty() && !big) {
+		counts = { 1000, 10000, 100000 };
+	}
+
+	auto dir = std::filesystem::temp_directory_path() / "broma-bench";
+	std::filesystem::create_directories(dir);
+
+	for (auto count : counts) {
+		std::mt19937 rng(0);
+		std::string source;
+		for (size_t i = 0; i < count; i++) {
+			writeClass(source, rng, i, fields);
+		}
+		print(std::to_string(count) + " classes", count, "classes", bench(dir, source));
+	}
+	if (big) {
+		std::mt19937 rng(0);
+		std::string source;
+		writeClass(source, rng, 0, big);
+		print("1 class of " + std::to_string(big) + " fields", big, "fields", bench(dir, source));
+	}
+
+	std::filesystem::remove_all(dir);
+}
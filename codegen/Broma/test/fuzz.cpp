@@ -0,0 +1,163 @@
+// Looks for inputs that crash Broma or that it parses much slower per byte
+// than usual, which is how the quadratic duplicate check was found.
+//
+// Built with Clang this is a libFuzzer target:
+//     broma-fuzz corpus/
+// Otherwise it has its own driver that mutates the bindings (or the files
+// given) at random for a while and saves the slowest inputs it finds:
+//     broma-fuzz [--seconds N] [--out dir] [files...]
+
+#include <broma.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+static bool parse(std::string const& source) {
+	// includes read whatever file the input names, which can block forever
+	if (source.find("#include") != std::string::npos) {
+		return false;
+	}
+	try {
+		broma::parse_string(source, "fuzz.bro");
+	}
+	catch (std::exception const&) {
+		// parse errors are expected, only crashes and hangs are bugs
+	}
+	return true;
+}
+
+extern "C" int LLVMFuzzerTestOneInput(uint8_t const* data, size_t size) {
+	parse(std::string(reinterpret_cast<char const*>(data), size));
+	return 0;
+}
+
+#ifndef BROMA_LIBFUZZER
+
+static char const* TOKENS[] = {
+	"class ", "Foo", "Bar::Baz", " : ", "cocos2d::CCNode", ", ", "{", "}", "(", ")", ";",
+	" = ", "mac ", "win ", "ios ", "android ", "0x1234", "0x", "int ", "void ", "bool ",
+	"gd::string ", "const", "&", "*", "static ", "virtual ", "inline ", "~", "PAD",
+	"[[docs(\"", "\")]]", "[[link(android)]]", "<", ">", "[", "]", "16", "name", " ",
+	"\n", "\t", "//", "/*", "*/", "\"", "\\", "{ return 0; }",
+};
+
+static std::string read(std::filesystem::path const& path) {
+	std::ifstream file(path, std::ios::binary);
+	std::stringstream ss;
+	ss << file.rdbuf();
+	return ss.str();
+}
+
+static std::string mutate(std::string const& seed, std::mt19937& rng) {
+	auto out = seed;
+	auto count = 1 + rng() % 16;
+	for (size_t i = 0; i < count; i++) {
+		auto at = out.empty() ? 0 : rng() % out.size();
+		switch (rng() % 4) {
+			case 0:
+				out.insert(at, TOKENS[rng() % std::size(TOKENS)]);
+				break;
+			case 1:
+				out.erase(at, rng() % 32);
+				break;
+			case 2: {
+				// duplicating a chunk makes long runs of the same fields
+				auto length = std::min<size_t>(rng() % 4096, out.size() - at);
+				out.insert(rng() % (out.size() + 1), out.substr(at, length));
+				break;
+			}
+			default:
+				if (!out.empty()) out[at] = static_cast<char>(rng());
+				break;
+		}
+	}
+	return out;
+}
+
+int main(int argc, char** argv) {
+	double seconds = 60;
+	std::filesystem::path outDir = "broma-fuzz-slow";
+	std::vector<std::string> seeds;
+
+	for (int i = 1; i < argc; i++) {
+		std::string arg = argv[i];
+		if (arg == "--seconds" && i + 1 < argc) {
+			seconds = std::stod(argv[++i]);
+		}
+		else if (arg == "--out" && i + 1 < argc) {
+			outDir = argv[++i];
+		}
+		else {
+			seeds.push_back(read(arg));
+		}
+	}
+	if (seeds.empty()) {
+		for (auto file : { "Cocos2d.bro", "GeometryDash.bro" }) {
+			if (std::filesystem::exists(file)) seeds.push_back(read(file));
+		}
+	}
+	if (seeds.empty()) {
+		seeds.push_back("class Foo : Bar {\n\tint m_value;\n\tvoid bar() = win 0x10;\n}\n");
+	}
+
+	// the errors of every broken input aren't interesting
+	std::stringstream discard;
+	std::cerr.rdbuf(discard.rdbuf());
+
+	std::mt19937 rng(std::random_device {}());
+	auto const start = std::chrono::steady_clock::now();
+	auto const elapsed = [&] {
+		return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	};
+
+	// the first inputs set what a normal speed is, anything well over it
+	// after that is saved
+	double usual = 0;
+	double worst = 0;
+	size_t runs = 0;
+	size_t saved = 0;
+
+	auto const time = [&](std::string const& input) {
+		auto const before = std::chrono::steady_clock::now();
+		if (!parse(input)) return;
+		auto const nsPerByte = std::chrono::duration<double, std::nano>(
+			std::chrono::steady_clock::now() - before
+		).count() / (input.size() + 1);
+
+		runs++;
+		if (runs <= 16) {
+			usual = std::max(usual, nsPerByte);
+			return;
+		}
+		if (nsPerByte > usual * 8 && input.size() > 1024) {
+			std::filesystem::create_directories(outDir);
+			auto path = outDir / ("slow-" + std::to_string(saved++) + ".bro");
+			std::ofstream(path, std::ios::binary) << input;
+			std::cout << path.string() << ": " << nsPerByte << " ns/byte, usually "
+				<< usual << "\n";
+		}
+		worst = std::max(worst, nsPerByte);
+	};
+
+	for (auto& seed : seeds) {
+		time(seed);
+	}
+	while (elapsed() < seconds) {
+		time(mutate(seeds[rng() % seeds.size()], rng));
+	}
+
+	std::cout << runs << " inputs in " << elapsed() << " s, usually " << usual
+		<< " ns/byte, worst " << worst << " ns/byte, " << saved << " saved\n";
+	return saved ? 1 : 0;
+}
+
+#endif
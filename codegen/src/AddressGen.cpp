@@ -3,7 +3,41 @@
 
 namespace { namespace format_strings {
 
+	char const* declare_table = R"GEN(
+// offsets of the functions bound to a fixed offset from the base of the game,
+// relocated into table in one pass when the binary is loaded (see
+// GeneratedSource.cpp). the {resolved} functions found through addresser
+// aren't in it, and are resolved on first use
+static constexpr size_t count = {count};
+static constexpr uintptr_t offsets[count] = {{{offsets}
+}};
+alignas(64) GEODE_HIDDEN static inline uintptr_t table[count] = {{}};
+
+static void relocate() {{
+	auto base = base::get();
+	for (size_t i = 0; i < count; ++i) {{
+		table[i] = base + offsets[i];
+	}}
+}}
+)GEN";
+
+	char const* declare_no_table = R"GEN(
+// no functions bound to a fixed offset. the {resolved} functions found through
+// addresser are resolved on first use
+static void relocate() {{}}
+)GEN";
+
 	char const* declare_address = R"GEN(
+GEODE_INLINE GEODE_HIDDEN static uintptr_t address{index}() {{
+	return table[{slot}];
+}}
+)GEN";
+
+	// these need the member function pointer, so they can only be found
+	// when they're used. resolving them all up front would make every mod
+	// import, and for virtuals copy construct, every class that's bound this
+	// way, most of which it never calls
+	char const* declare_resolved_address = R"GEN(
 GEODE_INLINE GEODE_HIDDEN static uintptr_t address{index}() {{
 	static uintptr_t ret = {address};
 	return ret;
@@ -12,43 +46,55 @@ GEODE_INLINE GEODE_HIDDEN static uintptr_t address{index}() {{
 
 }}
 
-std::string generateAddressHeader(Root& root) {
+std::string generateAddressHeader(codegen::Target& target, Root& root) {
 	std::string output;
+	std::string offsets;
+	size_t count = 0;
+	size_t resolved = 0;
 
 	TypeBank bank;
-	bank.loadFrom(root);
+	bank.loadFrom(target, root);
 
 	for (auto& c : root.classes) {
 
 		for (auto& field : c.fields) {
-			std::string address_str;
-
 			auto fn = field.get_as<FunctionBindField>();
 
 			if (!fn) {
 				continue;
 			}
 
-			if (codegen::getStatus(field) == BindStatus::Binded) {
+			if (target.getStatus(field) == BindStatus::Binded) {
 				const auto ids = bank.getIDs(fn->beginning, c.name);
 
-				address_str = fmt::format("addresser::get{}Virtual((types::member{})(&{}::{}))",
-					str_if("Non", !fn->beginning.is_virtual),
-					ids.member,
-					field.parent,
-					fn->beginning.name
+				output += fmt::format(::format_strings::declare_resolved_address,
+					fmt::arg("address", fmt::format("addresser::get{}Virtual((types::member{})(&{}::{}))",
+						str_if("Non", !fn->beginning.is_virtual),
+						ids.member,
+						field.parent,
+						fn->beginning.name
+					)),
+					fmt::arg("index", field.field_id)
+				);
+				resolved++;
+			} else if (target.getStatus(field) == BindStatus::NeedsBinding) {
+				offsets += fmt::format("\n\t0x{:x},", target.platformNumber(fn->binds));
+				output += fmt::format(::format_strings::declare_address,
+					fmt::arg("slot", count++),
+					fmt::arg("index", field.field_id)
 				);
-			} else if (codegen::getStatus(field) == BindStatus::NeedsBinding) {
-				address_str = fmt::format("base::get() + 0x{:x}", codegen::platformNumber(fn->binds));
-			} else { 
-				continue;
 			}
-
-			output += fmt::format(::format_strings::declare_address,
-				fmt::arg("address", address_str),
-				fmt::arg("index", field.field_id)
-			);
 		}
 	}
-	return output;
+
+	if (count == 0) {
+		return fmt::format(::format_strings::declare_no_table,
+			fmt::arg("resolved", resolved)
+		) + output;
+	}
+	return fmt::format(::format_strings::declare_table,
+		fmt::arg("count", count),
+		fmt::arg("offsets", offsets),
+		fmt::arg("resolved", resolved)
+	) + output;
 }
@@ -69,7 +69,7 @@ public:
 )GEN";
 }}
 
-std::string generateBindingHeader(Root& root, ghc::filesystem::path const& singleFolder) {
+std::string generateBindingHeader(codegen::Target& target, Root& root, ghc::filesystem::path const& singleFolder) {
     std::string output;
 
    	for (auto& cls : root.classes) {
@@ -81,6 +81,10 @@ std::string generateBindingHeader(Root& root, ghc::filesystem::path const& singl
             fmt::arg("file_name", filename)
         );
 
+        if (target.cache.isFresh(singleFolder / filename, codegen::hashClass(cls))) {
+            continue;
+        }
+
         std::string single_output;
         if (cls.name != "GDString") {
             single_output += format_strings::class_includes;
@@ -133,7 +137,7 @@ std::string generateBindingHeader(Root& root, ghc::filesystem::path const& singl
                 );
                 continue;
             } else if (auto p = field.get_as<PadField>()) {
-                auto hardcode = codegen::platformNumber(p->amount);
+                auto hardcode = target.platformNumber(p->amount);
 
                 if (hardcode) {
                     single_output += fmt::format(format_strings::pad_definition, fmt::arg("hardcode", hardcode));
@@ -146,7 +150,7 @@ std::string generateBindingHeader(Root& root, ghc::filesystem::path const& singl
             } else if (auto fn = field.get_as<FunctionBindField>()) {
                 fb = &fn->beginning;
 
-                if (!codegen::platformNumber(fn->binds)) {
+                if (!target.platformNumber(fn->binds)) {
                     used_format = format_strings::error_definition;
 
                     if (fb->is_virtual)
@@ -0,0 +1,117 @@
+#include "Shared.hpp"
+
+using namespace codegen;
+
+static void hashType(Hash& hash, Type const& type) {
+    hash.add(type.is_struct);
+    hash.add(type.name);
+}
+
+static void hashPlatformNumber(Hash& hash, PlatformNumber const& number) {
+    hash.add(number.mac);
+    hash.add(number.ios);
+    hash.add(number.win);
+    hash.add(number.android);
+}
+
+static void hashFunction(Hash& hash, FunctionBegin const& fn) {
+    hashType(hash, fn.ret);
+    hash.add(static_cast<uint64_t>(fn.type));
+    hash.add(fn.args.size());
+    for (auto& [type, name] : fn.args) {
+        hashType(hash, type);
+        hash.add(name);
+    }
+    hash.add(fn.is_const);
+    hash.add(fn.is_virtual);
+    hash.add(fn.is_static);
+    hash.add(fn.docs);
+    hash.add(fn.name);
+}
+
+uint64_t codegen::hashClass(Class const& cls) {
+    Hash hash;
+    hash.add(cls.name);
+    hash.add(cls.superclasses.size());
+    for (auto& super : cls.superclasses) {
+        hash.add(super);
+    }
+    hash.add(cls.depends.size());
+    for (auto& dep : cls.depends) {
+        hash.add(dep);
+    }
+    hash.add(cls.fields.size());
+    for (auto& field : cls.fields) {
+        hash.add(field.parent);
+        hash.add(field.inner.index());
+        if (auto inl = field.get_as<InlineField>()) {
+            hash.add(inl->inner);
+        }
+        else if (auto ool = field.get_as<OutOfLineField>()) {
+            hashFunction(hash, ool->beginning);
+            hash.add(ool->inner);
+        }
+        else if (auto bind = field.get_as<FunctionBindField>()) {
+            hashFunction(hash, bind->beginning);
+            hashPlatformNumber(hash, bind->binds);
+        }
+        else if (auto pad = field.get_as<PadField>()) {
+            hashPlatformNumber(hash, pad->amount);
+        }
+        else if (auto member = field.get_as<MemberField>()) {
+            hash.add(member->name);
+            hashType(hash, member->type);
+            hash.add(member->count);
+        }
+    }
+    return hash.value;
+}
+
+void OutputCache::load(ghc::filesystem::path const& file, std::string const& generator) {
+    m_file = file;
+    m_generator = generator;
+
+    std::ifstream input(file);
+    std::string line;
+    if (!std::getline(input, line) || line != generator) {
+        return;
+    }
+    while (std::getline(input, line)) {
+        auto space = line.find(' ');
+        if (space == std::string::npos) continue;
+        m_old[line.substr(space + 1)] = std::stoull(line.substr(0, space), nullptr, 16);
+    }
+}
+
+void OutputCache::save() {
+    // never loaded, since the build of codegen couldn't be identified
+    if (m_file.empty()) return;
+
+    std::string output = m_generator + "\n";
+    for (auto& [file, key] : m_new) {
+        output += fmt::format("{:016x} {}\n", key, file);
+    }
+    writeFile(m_file, output);
+}
+
+bool OutputCache::isFresh(ghc::filesystem::path const& output, uint64_t key) {
+    // relative so the output folder can be moved without invalidating it
+    auto name = output.lexically_relative(m_file.parent_path()).generic_string();
+    std::lock_guard lock(m_mutex);
+    m_new[name] = key;
+    auto old = m_old.find(name);
+    if (old != m_old.end() && old->second == key && ghc::filesystem::exists(output)) {
+        m_fresh += 1;
+        return true;
+    }
+    m_stale += 1;
+    return false;
+}
+
+size_t OutputCache::fresh() const {
+    return m_fresh;
+}
+
+size_t OutputCache::stale() const {
+    return m_stale;
+}
@@ -1,43 +1,155 @@
 #include "Shared.hpp"
 #include <fs/filesystem.hpp> // bruh
+#include <future>
+#include <memory>
 
 using namespace codegen;
 
+// identifies this build of codegen, so outputs cached by another one aren't
+// reused. empty if the executable can't be found
+static std::string generatorID(char const* exe, std::string const& platform) {
+    std::error_code ec;
+    auto path = ghc::filesystem::canonical(exe, ec);
+    if (ec) return "";
+    auto size = ghc::filesystem::file_size(path, ec);
+    auto time = ghc::filesystem::last_write_time(path, ec);
+    if (ec) return "";
+    return fmt::format("{} {} {}", platform, size, time.time_since_epoch().count());
+}
+
+static Platform parsePlatform(std::string const& name) {
+    if (name == "Win32") return Platform::Windows;
+    else if (name == "MacOS") return Platform::Mac;
+    else if (name == "iOS") return Platform::iOS;
+    else if (name == "Android") return Platform::Android;
+    else throw codegen::error("Invalid platform {}\n", name);
+}
+
+// Usage: Codegen <platforms> <bindings folder> <output folder> [--timings]
+// where platforms is one platform, like Win32, or a comma separated list of
+// them. The bindings are parsed once for all of them, and every platform is
+// generated into its own folder under the output folder
 int main(int argc, char** argv) try {
-	if (argc != 4) throw codegen::error("Invalid number of parameters (expected 3 found {})", argc-1);
+    if (argc != 4 && !(argc == 5 && std::string(argv[4]) == "--timings")) {
+        throw codegen::error("Invalid number of parameters (expected 3 found {})", argc - 1);
+    }
 
-    std::string p = argv[1];
+    std::vector<std::string> names;
+    for (std::string list = argv[1];;) {
+        auto comma = list.find(',');
+        names.push_back(list.substr(0, comma));
+        if (comma == std::string::npos) break;
+        list.erase(0, comma + 1);
+    }
 
-    if (p == "Win32") codegen::platform = Platform::Windows;
-    else if (p == "MacOS") codegen::platform = Platform::Mac;
-    else if (p == "iOS") codegen::platform = Platform::iOS;
-    else if (p == "Android") codegen::platform = Platform::Android;
-    else throw codegen::error("Invalid platform {}\n", p);
+    // targets hold their cache, which can't be moved
+    std::vector<std::unique_ptr<Target>> targets;
+    for (auto& name : names) {
+        auto& target = *targets.emplace_back(std::make_unique<Target>());
+        target.platform = parsePlatform(name);
+        target.name = name;
+        target.writeDir = names.size() == 1 ?
+            ghc::filesystem::path(argv[3]) / "Geode" :
+            ghc::filesystem::path(argv[3]) / name / "Geode";
+    }
 
+    auto exe = argv[0];
     chdir(argv[2]);
 
-    auto writeDir = ghc::filesystem::path(argv[3]) / "Geode";
-    ghc::filesystem::create_directories(writeDir);
-    ghc::filesystem::create_directories(writeDir / "modify");
-    ghc::filesystem::create_directories(writeDir / "binding");
+    for (auto& target : targets) {
+        ghc::filesystem::create_directories(target->writeDir);
+        ghc::filesystem::create_directories(target->writeDir / "modify");
+        ghc::filesystem::create_directories(target->writeDir / "binding");
+
+        auto generator = generatorID(exe, target->name);
+        if (generator.size()) {
+            target->cache.load(target->writeDir / "codegen-cache.txt", generator);
+        }
+    }
 
-    Root root = broma::parse_file("Entry.bro");
+    Root root;
+    timings.time("parse", [&] {
+        root = broma::parse_file("Entry.bro");
+    });
 
-    for (auto cls : root.classes) {
-        for (auto dep : cls.depends) {
-            if(!can_find(dep, "cocos2d::") && std::find(root.classes.begin(), root.classes.end(), dep) == root.classes.end()) {
-                throw codegen::error("Class {} depends on unknown class {}", cls.name, dep);
+    timings.time("check dependencies", [&] {
+        for (auto& cls : root.classes) {
+            for (auto& dep : cls.depends) {
+                if(!can_find(dep, "cocos2d::") && !root[dep]) {
+                    throw codegen::error("Class {} depends on unknown class {}", cls.name, dep);
+                }
             }
         }
+    });
+
+    // the generators only read the tree, so they can all run at once, for
+    // every platform
+    std::vector<std::future<void>> tasks;
+    auto generate = [&](Target& target, char const* file, auto func) {
+        auto name = targets.size() == 1 ? std::string(file) : target.name + " " + file;
+        tasks.push_back(std::async(std::launch::async, [&root, &target, name, file, func] {
+            timings.time(name, [&] {
+                writeFile(target.writeDir / file, func(target, root));
+            });
+        }));
+    };
+    // these don't depend on the platform, so they're only generated once
+    auto generateShared = [&](char const* file, auto func) {
+        tasks.push_back(std::async(std::launch::async, [&root, &targets, file, func] {
+            timings.time(file, [&] {
+                auto output = func(root);
+                for (auto& target : targets) {
+                    writeFile(target->writeDir / file, output);
+                }
+            });
+        }));
+    };
+    timings.time("generate", [&] {
+        generateShared("GeneratedWrapper.hpp", [](Root& root) {
+            return generateWrapperHeader(root);
+        });
+        generateShared("GeneratedPredeclare.hpp", [](Root& root) {
+            return generatePredeclareHeader(root);
+        });
+        for (auto& target : targets) {
+            generate(*target, "GeneratedAddress.hpp", [](Target& target, Root& root) {
+                return generateAddressHeader(target, root);
+            });
+            generate(*target, "GeneratedModify.hpp", [](Target& target, Root& root) {
+                return generateModifyHeader(target, root, target.writeDir / "modify");
+            });
+            generate(*target, "GeneratedType.hpp", [](Target& target, Root& root) {
+                return generateTypeHeader(target, root);
+            });
+            generate(*target, "GeneratedBinding.hpp", [](Target& target, Root& root) {
+                return generateBindingHeader(target, root, target.writeDir / "binding");
+            });
+            generate(*target, "GeneratedSource.cpp", [](Target& target, Root& root) {
+                return generateBindingSource(target, root);
+            });
+            generate(*target, "GeneratedSymbols.hpp", [](Target& target, Root& root) {
+                return generateSymbolHeader(target, root);
+            });
+        }
+        // rethrows errors from the generators
+        for (auto& task : tasks) {
+            task.get();
+        }
+    });
+
+    for (auto& target : targets) {
+        target->cache.save();
     }
 
-    writeFile(writeDir / "GeneratedAddress.hpp", generateAddressHeader(root));
-    writeFile(writeDir / "GeneratedModify.hpp", generateModifyHeader(root, writeDir / "modify"));
-    writeFile(writeDir / "GeneratedWrapper.hpp", generateWrapperHeader(root));
-    writeFile(writeDir / "GeneratedType.hpp", generateTypeHeader(root));
-    writeFile(writeDir / "GeneratedBinding.hpp", generateBindingHeader(root, writeDir / "binding"));
-    writeFile(writeDir / "GeneratedPredeclare.hpp", generatePredeclareHeader(root));
-    writeFile(writeDir / "GeneratedSource.cpp", generateBindingSource(root));
+    if (argc == 5) {
+        timings.print();
+        for (auto& target : targets) {
+            std::cout << fmt::format(
+                "{}: {} class files up to date, {} generated\n", target->name,
+                target->cache.fresh(), target->cache.stale()
+            );
+        }
+    }
 } catch(std::exception& e) {
     std::cout << "Codegen error: " << e.what() << "\n";
     return 1;
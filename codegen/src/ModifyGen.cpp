@@ -20,9 +20,9 @@ namespace {
         char const* wrap_end = R"GEN(
 	}
 )GEN";
-        // requires: class_name
+        // requires: binding, class_name, wrap
         char const* modify_start = R"GEN(#pragma once
-#include <Geode/modify/Modify.hpp>
+{binding}#include <Geode/modify/Modify.hpp>
 #include <Geode/modify/Field.hpp>
 #include <Geode/modify/InternalMacros.hpp>
 using namespace geode::modifier;
@@ -50,21 +50,38 @@ namespace geode::modifier {{
 
         char const* modify_include = R"GEN(#include "modify/{file_name}"
 )GEN";
+
+        char const* binding_include = R"GEN(#include <Geode/binding/{file_name}>
+)GEN";
     }
 }
 
-std::string generateModifyHeader(Root& root, ghc::filesystem::path const& singleFolder) {
+std::string generateModifyHeader(codegen::Target& target, Root& root, ghc::filesystem::path const& singleFolder) {
     std::string output;
 
     TypeBank bank;
-    bank.loadFrom(root);
+    bank.loadFrom(target, root);
 
-    for (auto c : root.classes) {
+    for (auto& c : root.classes) {
         if (c.name == "cocos2d") continue;
 
         std::string filename = (codegen::getUnqualifiedClassName(c.name) + ".hpp");
         output += fmt::format(format_strings::modify_include, fmt::arg("file_name", filename));
 
+        // the indices come from all classes, so a change elsewhere can
+        // renumber this one too
+        codegen::Hash key;
+        key.add(codegen::hashClass(c));
+        for (auto& f : c.fields) {
+            key.add(static_cast<uint64_t>(f.field_id));
+            if (target.getStatus(f) != BindStatus::Unbindable) {
+                key.add(static_cast<uint64_t>(bank.getPure(*f.get_fn(), c.name)));
+            }
+        }
+        if (target.cache.isFresh(singleFolder / filename, key.value)) {
+            continue;
+        }
+
         std::string single_output;
         std::string wrap;
 
@@ -83,13 +100,20 @@ std::string generateModifyHeader(Root& root, ghc::filesystem::path const& single
         }
         wrap += format_strings::wrap_end;
 
+        // cocos classes don't have their own binding headers
+        std::string binding;
+        if (!can_find(c.name, "cocos2d")) {
+            binding = fmt::format(format_strings::binding_include, fmt::arg("file_name", filename));
+        }
+
         single_output += fmt::format(
-            format_strings::modify_start, fmt::arg("class_name", c.name), fmt::arg("wrap", wrap)
+            format_strings::modify_start, fmt::arg("binding", binding),
+            fmt::arg("class_name", c.name), fmt::arg("wrap", wrap)
         );
 
         // modify
         for (auto& f : c.fields) {
-            if (codegen::getStatus(f) != BindStatus::Unbindable) {
+            if (target.getStatus(f) != BindStatus::Unbindable) {
                 auto begin = f.get_fn();
 
                 std::string function_name;
@@ -104,7 +128,7 @@ std::string generateModifyHeader(Root& root, ghc::filesystem::path const& single
                     format_strings::apply_function, fmt::arg("addr_index", f.field_id),
                     fmt::arg("pure_index", bank.getPure(*begin, c.name)),
                     fmt::arg("class_name", c.name), fmt::arg("function_name", function_name),
-                    fmt::arg("function_convention", codegen::getConvention(f))
+                    fmt::arg("function_convention", target.getConvention(f))
                 );
             }
         }
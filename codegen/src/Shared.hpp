@@ -2,10 +2,15 @@
 
 #include <array>
 #include <broma.hpp>
+#include <chrono>
 #include <fmt/format.h>
 #include <fmt/ranges.h>
 #include <fs/filesystem.hpp> // bruh
 #include <fstream>
+#include <map>
+#include <iostream>
+#include <mutex>
+#include <unordered_map>
 
 using std::istreambuf_iterator;
 
@@ -19,14 +24,19 @@ using std::istreambuf_iterator;
     #include <unistd.h>
 #endif
 
-std::string generateAddressHeader(Root& root);
-std::string generateModifyHeader(Root& root, ghc::filesystem::path const& singleFolder);
+namespace codegen {
+    struct Target;
+}
+
+std::string generateAddressHeader(codegen::Target& target, Root& root);
+std::string generateModifyHeader(codegen::Target& target, Root& root, ghc::filesystem::path const& singleFolder);
 std::string generateWrapperHeader(Root& root);
-std::string generateTypeHeader(Root& root);
-std::string generateBindingHeader(Root& root, ghc::filesystem::path const& singleFolder);
+std::string generateTypeHeader(codegen::Target& target, Root& root);
+std::string generateBindingHeader(codegen::Target& target, Root& root, ghc::filesystem::path const& singleFolder);
 std::string generatePredeclareHeader(Root& root);
-std::string generateBindingSource(Root& root);
+std::string generateBindingSource(codegen::Target& target, Root& root);
 std::string generateTidyHeader(Root& root);
+std::string generateSymbolHeader(codegen::Target& target, Root& root);
 
 inline void writeFile(ghc::filesystem::path const& writePath, std::string const& output) {
     std::ifstream readfile;
@@ -68,53 +78,6 @@ namespace codegen {
         return codegen_error(fmt::format(args...).c_str());
     }
 
-    inline Platform platform;
-
-    inline uintptr_t platformNumber(PlatformNumber const& p) {
-        switch (codegen::platform) {
-            case Platform::Mac: return p.mac;
-            case Platform::Windows: return p.win;
-            case Platform::iOS: return p.ios;
-            case Platform::Android: return p.android;
-            default: // unreachable
-                return p.win;
-        }
-    }
-
-    inline BindStatus getStatus(Field const& field) {
-        FunctionBegin const* fb;
-
-        if (auto fn = field.get_as<FunctionBindField>()) {
-            if (platformNumber(fn->binds)) return BindStatus::NeedsBinding;
-
-            fb = &fn->beginning;
-        }
-        else if (auto fn = field.get_as<OutOfLineField>()) {
-            fb = &fn->beginning;
-        }
-        else return BindStatus::Unbindable;
-
-        // if (field.parent.rfind("GDString", 0) == 0) return BindStatus::NeedsBinding;
-
-        if (platform == Platform::Android) {
-            for (auto& [type, name] : fb->args) {
-                if (type.name.find("gd::") != std::string::npos) return BindStatus::NeedsBinding;
-            }
-
-            if (field.parent.rfind("cocos2d::CCEGLView", 0) == 0) return BindStatus::Unbindable;
-
-            return BindStatus::Binded;
-        }
-
-        if (fb->type == FunctionType::Normal) {
-            if (field.parent.rfind("fmod::", 0) == 0) return BindStatus::Binded;
-            if (field.parent.rfind("cocos2d::", 0) == 0 && platform == Platform::Windows)
-                return BindStatus::Binded;
-        }
-
-        return BindStatus::Unbindable;
-    }
-
     inline std::string getParameters(FunctionBegin const& f) { // int p0, float p1
         std::vector<std::string> parameters;
 
@@ -145,25 +108,11 @@ namespace codegen {
         return fmt::format("{}", fmt::join(parameters, ", "));
     }
 
-    inline std::string getConvention(Field& f) {
-        if (codegen::platform != Platform::Windows) return "DefaultConv";
-
-        if (auto fn = f.get_fn()) {
-            auto status = getStatus(f);
-
-            if (fn->is_static) {
-                if (status == BindStatus::Binded) return "x86::Cdecl";
-                else return "x86::Optcall";
-            }
-            else if (fn->is_virtual) {
-                return "x86::Thiscall";
-            }
-            else {
-                if (status == BindStatus::Binded) return "x86::Thiscall";
-                else return "x86::Membercall";
-            }
-        }
-        else throw codegen::error("Tried to get convention of non-function");
+    // whether the compiler can call with a convention from getConvention by
+    // itself, without reordering the arguments
+    inline bool isNativeConvention(std::string const& convention) {
+        return convention == "DefaultConv" || convention == "x86::Thiscall" ||
+            convention == "x86::Cdecl";
     }
 
     inline std::string getUnqualifiedClassName(std::string const& s) {
@@ -171,4 +120,160 @@ namespace codegen {
         if (index == std::string::npos) return s;
         return s.substr(index + 2);
     }
+
+    // FNV-1a, only used to tell whether inputs changed between runs
+    struct Hash {
+        uint64_t value = 0xcbf29ce484222325;
+
+        inline void add(void const* data, size_t size) {
+            for (size_t i = 0; i < size; i++) {
+                value ^= static_cast<uint8_t const*>(data)[i];
+                value *= 0x100000001b3;
+            }
+        }
+
+        inline void add(uint64_t number) {
+            this->add(&number, sizeof(number));
+        }
+
+        inline void add(std::string const& str) {
+            // length first so "ab" + "c" and "a" + "bc" differ
+            this->add(static_cast<uint64_t>(str.size()));
+            this->add(str.data(), str.size());
+        }
+    };
+
+    // hash of everything in a class, except the ids of its fields
+    uint64_t hashClass(Class const& cls);
+
+    // Remembers what each per-class file was generated from, so files of
+    // classes that haven't changed don't have to be generated again. Stored
+    // next to the generated files
+    class OutputCache {
+        std::mutex m_mutex;
+        ghc::filesystem::path m_file;
+        std::string m_generator;
+        std::unordered_map<std::string, uint64_t> m_old;
+        // ordered so the cache file only changes when its contents do
+        std::map<std::string, uint64_t> m_new;
+        size_t m_fresh = 0;
+        size_t m_stale = 0;
+
+    public:
+        // generator identifies the build of codegen & the platform; if it's
+        // different from last time, everything is generated again
+        void load(ghc::filesystem::path const& file, std::string const& generator);
+        void save();
+
+        // whether the file was last generated from the same key and still
+        // exists. if not, the caller has to generate it
+        bool isFresh(ghc::filesystem::path const& output, uint64_t key);
+
+        size_t fresh() const;
+        size_t stale() const;
+    };
+
+    // A platform to generate for, along with the folder its output goes
+    // to. Everything that depends on the platform is answered here, so
+    // several platforms can be generated at the same time
+    struct Target {
+        Platform platform;
+        // the name used on the command line, like Win32
+        std::string name;
+        ghc::filesystem::path writeDir;
+        OutputCache cache;
+
+        inline uintptr_t platformNumber(PlatformNumber const& p) const {
+            switch (platform) {
+                case Platform::Mac: return p.mac;
+                case Platform::Windows: return p.win;
+                case Platform::iOS: return p.ios;
+                case Platform::Android: return p.android;
+                default: // unreachable
+                    return p.win;
+            }
+        }
+
+        inline BindStatus getStatus(Field const& field) const {
+            FunctionBegin const* fb;
+
+            if (auto fn = field.get_as<FunctionBindField>()) {
+                if (platformNumber(fn->binds)) return BindStatus::NeedsBinding;
+
+                fb = &fn->beginning;
+            }
+            else if (auto fn = field.get_as<OutOfLineField>()) {
+                fb = &fn->beginning;
+            }
+            else return BindStatus::Unbindable;
+
+            // if (field.parent.rfind("GDString", 0) == 0) return BindStatus::NeedsBinding;
+
+            if (platform == Platform::Android) {
+                for (auto& [type, name] : fb->args) {
+                    if (type.name.find("gd::") != std::string::npos) return BindStatus::NeedsBinding;
+                }
+
+                if (field.parent.rfind("cocos2d::CCEGLView", 0) == 0) return BindStatus::Unbindable;
+
+                return BindStatus::Binded;
+            }
+
+            if (fb->type == FunctionType::Normal) {
+                if (field.parent.rfind("fmod::", 0) == 0) return BindStatus::Binded;
+                if (field.parent.rfind("cocos2d::", 0) == 0 && platform == Platform::Windows)
+                    return BindStatus::Binded;
+            }
+
+            return BindStatus::Unbindable;
+        }
+
+        inline std::string getConvention(Field& f) const {
+            if (platform != Platform::Windows) return "DefaultConv";
+
+            if (auto fn = f.get_fn()) {
+                auto status = getStatus(f);
+
+                if (fn->is_static) {
+                    if (status == BindStatus::Binded) return "x86::Cdecl";
+                    else return "x86::Optcall";
+                }
+                else if (fn->is_virtual) {
+                    return "x86::Thiscall";
+                }
+                else {
+                    if (status == BindStatus::Binded) return "x86::Thiscall";
+                    else return "x86::Membercall";
+                }
+            }
+            else throw codegen::error("Tried to get convention of non-function");
+        }
+    };
+
+    // Time spent in each step, printed with --timings
+    class Timings {
+        std::mutex m_mutex;
+        std::vector<std::pair<std::string, double>> m_phases;
+
+    public:
+        template <class F>
+        void time(std::string const& phase, F&& func) {
+            auto start = std::chrono::steady_clock::now();
+            func();
+            auto time = std::chrono::duration<double, std::milli>(
+                std::chrono::steady_clock::now() - start
+            );
+            std::lock_guard lock(m_mutex);
+            m_phases.push_back({ phase, time.count() });
+        }
+
+        void print() {
+            std::lock_guard lock(m_mutex);
+            for (auto& [phase, time] : m_phases) {
+                std::cout << fmt::format("{:>28}: {:8.2f}ms\n", phase, time);
+            }
+        }
+    };
+
+    inline Timings timings;
 }
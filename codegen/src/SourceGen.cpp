@@ -14,27 +14,28 @@ using cocos2d::CCDestructor;
 using namespace geode::core::meta; // Default convention
 using namespace geode::core::meta::x86; // Windows x86 conventions, Function
 using namespace geode::modifier; // types
+
+// every binary has its own address table, filled in before any of its code
+// can call a binding
+static auto s_relocated = (addresses::relocate(), 0);
 )CAC";
 
 	char const* declare_member = R"GEN(
 types::ret{ret_index} {class_name}::{function_name}({parameters}){const} {{
-	auto func = Function<types::meta{meta_index}, {convention}>({{addresses::address{addr_index}()}});
-	return func(this{parameter_comma}{arguments});
+	return {function}(this{parameter_comma}{arguments});
 }}
 )GEN";
 
 	char const* declare_virtual = R"GEN(
 types::ret{ret_index} {class_name}::{function_name}({parameters}){const} {{
 	auto self = addresser::thunkAdjust((types::member{member_index})(&{class_name}::{function_name}), this);
-	auto func = Function<types::meta{meta_index}, {convention}>({{addresses::address{addr_index}()}});
-	return func(self{parameter_comma}{arguments});
+	return {function}(self{parameter_comma}{arguments});
 }}
 )GEN";
 
 	char const* declare_static = R"GEN(
 types::ret{ret_index} {class_name}::{function_name}({parameters}){const} {{
-	auto func = Function<types::meta{meta_index}, {convention}>({{addresses::address{addr_index}()}});
-	return func({arguments});
+	return {function}({arguments});
 }}
 )GEN";
 
@@ -43,8 +44,7 @@ types::ret{ret_index} {class_name}::{function_name}({parameters}){const} {{
 	// basically we destruct it once by calling the gd function, 
 	// then lock it, so that other gd destructors dont get called
 	if (CCDestructor::lock(this)) return;
-	auto func = Function<types::meta{meta_index}, {convention}>({{addresses::address{addr_index}()}});
-	func(this{parameter_comma}{arguments});
+	{function}(this{parameter_comma}{arguments});
 	// we need to construct it back so that it uhhh ummm doesnt crash
 	// while going to the child destructors
 	auto thing = new (this) {class_name}(std::monostate(), sizeof({class_name}));
@@ -59,11 +59,16 @@ types::ret{ret_index} {class_name}::{function_name}({parameters}){const} {{
 	// no crashes :pray:
 	CCDestructor::lock(this) = true;
 	{class_name}::~{unqualified_class_name}();
-	auto func = Function<types::meta{meta_index}, {convention}>({{addresses::address{addr_index}()}});
-	func(this{parameter_comma}{arguments});
+	{function}(this{parameter_comma}{arguments});
 }}
 )GEN";
 
+	// conventions the compiler supports are called through a plain
+	// function pointer, the others (optcall and membercall) still need
+	// Function to reorder the arguments
+	char const* native_function = "reinterpret_cast<FunctionPointer<types::meta{meta_index}, {convention}>>(addresses::address{addr_index}())";
+	char const* wrapped_function = "Function<types::meta{meta_index}, {convention}>({{addresses::address{addr_index}()}})";
+
 	char const* ool_function_definition = R"GEN(
 {return} {class_name}::{function_name}({parameters}){const} {definition}
 )GEN";
@@ -73,26 +78,26 @@ types::ret{ret_index} {class_name}::{function_name}({parameters}){const} {{
 )GEN";
 }}
 
-std::string generateBindingSource(Root& root) {
+std::string generateBindingSource(codegen::Target& target, Root& root) {
 	std::string output(format_strings::source_start);
 
 	TypeBank bank;
-	bank.loadFrom(root);
+	bank.loadFrom(target, root);
 
 	for (auto& c : root.classes) {
 
 		for (auto& f : c.fields) {
 			if (auto i = f.get_as<InlineField>()) {
-				if (codegen::platform == Platform::Mac || codegen::platform == Platform::iOS) {
+				if (target.platform == Platform::Mac || target.platform == Platform::iOS) {
 					if (can_find(c.name, "cocos2d"))
 						output += i->inner + "\n";
 				}
 			} else if (auto fn = f.get_as<OutOfLineField>()) {
-				if (codegen::getStatus(f) != BindStatus::Unbindable)
+				if (target.getStatus(f) != BindStatus::Unbindable)
 					continue;
 
 				// no cocos2d definitions on windows
-				if (codegen::platform == Platform::Windows && f.parent.rfind("cocos2d::", 0) == 0) {
+				if (target.platform == Platform::Windows && f.parent.rfind("cocos2d::", 0) == 0) {
 					continue;
 				}
 
@@ -120,7 +125,7 @@ std::string generateBindingSource(Root& root) {
 				}
 				
 			} else if (auto fn = f.get_as<FunctionBindField>()) {
-				if (codegen::getStatus(f) != BindStatus::NeedsBinding)
+				if (target.getStatus(f) != BindStatus::NeedsBinding)
 					continue;
 
 				char const* used_declare_format;
@@ -143,17 +148,24 @@ std::string generateBindingSource(Root& root) {
 					used_declare_format = format_strings::declare_virtual;
 
 				auto ids = bank.getIDs(fn->beginning, c.name);
+				auto convention = target.getConvention(f);
+				auto function = fmt::format(
+					codegen::isNativeConvention(convention) ?
+						format_strings::native_function :
+						format_strings::wrapped_function,
+					fmt::arg("meta_index", ids.meta),
+					fmt::arg("convention", convention),
+					fmt::arg("addr_index", f.field_id)
+				);
 
 				output += fmt::format(used_declare_format,
 					fmt::arg("class_name", c.name),
 					fmt::arg("unqualified_class_name", codegen::getUnqualifiedClassName(c.name)),
 					fmt::arg("const", str_if(" const ", fn->beginning.is_const)),
-					fmt::arg("convention", codegen::getConvention(f)),
+					fmt::arg("function", function),
 					fmt::arg("function_name", fn->beginning.name),
-					fmt::arg("meta_index", ids.meta),
 					fmt::arg("member_index", ids.member),
 					fmt::arg("ret_index", ids.ret),
-					fmt::arg("addr_index", f.field_id),
 					fmt::arg("parameters", codegen::getParameters(fn->beginning)),
 					fmt::arg("parameter_types", codegen::getParameterTypes(fn->beginning)),
 					fmt::arg("arguments", codegen::getParameterNames(fn->beginning)),
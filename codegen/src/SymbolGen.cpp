@@ -0,0 +1,62 @@
+#include "Shared.hpp"
+#include <algorithm>
+
+namespace { namespace format_strings {
+
+	// std::array so that the table can be empty. the names are separate
+	// literals since MSVC doesn't allow string literals over 64KB
+	char const* symbol_table = R"GEN(#pragma once
+
+#include <array>
+#include <cstdint>
+
+// the functions bound to an offset from the base of the game, sorted by the
+// offset, for finding which function an address is in
+static constexpr std::array<uint32_t, {count}> GENERATED_SYMBOL_OFFSETS = {{{offsets}
+}};
+static constexpr std::array<char const*, {count}> GENERATED_SYMBOL_NAMES = {{{names}
+}};
+)GEN";
+}}
+
+std::string generateSymbolHeader(codegen::Target& target, Root& root) {
+	std::vector<std::pair<uintptr_t, std::string>> symbols;
+
+	for (auto& c : root.classes) {
+		for (auto& field : c.fields) {
+			auto fn = field.get_as<FunctionBindField>();
+
+			if (!fn || target.getStatus(field) != BindStatus::NeedsBinding) {
+				continue;
+			}
+			symbols.emplace_back(
+				target.platformNumber(fn->binds), c.name + "::" + fn->beginning.name
+			);
+		}
+	}
+
+	// functions bound to the same address (like overloads that got merged)
+	// keep the one declared first
+	std::stable_sort(symbols.begin(), symbols.end(), [](auto const& a, auto const& b) {
+		return a.first < b.first;
+	});
+	symbols.erase(
+		std::unique(symbols.begin(), symbols.end(), [](auto const& a, auto const& b) {
+			return a.first == b.first;
+		}),
+		symbols.end()
+	);
+
+	std::string offsets;
+	std::string names;
+	for (auto& [offset, name] : symbols) {
+		offsets += fmt::format("\n\t0x{:x},", offset);
+		names += fmt::format("\n\t\"{}\",", name);
+	}
+
+	return fmt::format(::format_strings::symbol_table,
+		fmt::arg("count", symbols.size()),
+		fmt::arg("offsets", offsets),
+		fmt::arg("names", names)
+	);
+}
@@ -2,11 +2,11 @@
 #include "TypeOpt.hpp"
 #include <set>
 
-std::string generateTypeHeader(Root& root) {
+std::string generateTypeHeader(codegen::Target& target, Root& root) {
 	std::string output;
 
 	TypeBank bank;
-	bank.loadFrom(root);
+	bank.loadFrom(target, root);
 
 	std::map<std::string, int> used_returns;
 	std::map<std::string, int> used_funcs;
@@ -50,6 +50,63 @@ struct Ids {
 
 class TypeBank {
  	std::vector<Func> m_stuff;
+	// type & class names are interned, so the keys below are a few ints
+	// rather than strings that have to be formatted & hashed
+	using Key = std::vector<int>;
+	struct KeyHash {
+		size_t operator()(Key const& key) const {
+			codegen::Hash hash;
+			hash.add(key.data(), key.size() * sizeof(int));
+			return static_cast<size_t>(hash.value);
+		}
+	};
+	using KeyMap = std::unordered_map<Key, int, KeyHash>;
+
+	std::unordered_map<std::string, int> m_names;
+	// indices into m_stuff by the parts of the function getIDs matches on
+	std::vector<int> m_ret;
+	KeyMap m_pure;
+	KeyMap m_exact;
+	KeyMap m_static;
+	KeyMap m_firstInClass;
+	KeyMap m_lastInClass;
+
+	int intern(std::string const& name) {
+		return m_names.try_emplace(name, static_cast<int>(m_names.size())).first->second;
+	}
+
+	// -1 for names that were never interned, so keys with them match nothing
+	int lookup(std::string const& name) const {
+		auto found = m_names.find(name);
+		return found != m_names.end() ? found->second : -1;
+	}
+
+	template <class Name>
+	static Key pureKey(Func const& f, Name&& name) {
+		Key key { name(f.return_type), static_cast<int>(f.parameter_types.size()) };
+		for (auto& param : f.parameter_types) {
+			key.push_back(name(param));
+		}
+		return key;
+	}
+
+	template <class Name>
+	static Key classKey(Func const& f, Name&& name) {
+		auto key = TypeBank::pureKey(f, name);
+		key.push_back(name(f.class_name));
+		key.push_back(f.is_const);
+		return key;
+	}
+
+	static Key withType(Key key, Func const& f) {
+		key.push_back(static_cast<int>(f.type));
+		return key;
+	}
+
+	static int find(KeyMap const& map, Key const& key) {
+		auto found = map.find(key);
+		return found != map.end() ? found->second : -1;
+	}
  public:
 	static std::string getReturn(FunctionBegin const& fn, std::string const& parent) {
 		if (fn.type != FunctionType::Normal)
@@ -93,69 +150,96 @@ class TypeBank {
 		return f;
 	}
 
-	void loadFrom(Root& root) {
+	void loadFrom(codegen::Target const& target, Root& root) {
 		for (auto& c : root.classes) {
 			for (auto& f : c.fields) {
-				if (codegen::getStatus(f) == BindStatus::Unbindable)
+				if (target.getStatus(f) == BindStatus::Unbindable)
 					continue;
 
 				m_stuff.push_back(TypeBank::makeFunc(*f.get_fn(), c.name));
 			}
 		}
 
-		std::sort(m_stuff.begin(), m_stuff.end());
-		m_stuff.erase(std::unique(m_stuff.begin(), m_stuff.end()), m_stuff.end());
+		// sort by the string keys, computed once rather than on every compare
+		std::vector<std::pair<std::string, Func>> keyed;
+		keyed.reserve(m_stuff.size());
+		for (auto& f : m_stuff) {
+			keyed.push_back({ f.toStr(), std::move(f) });
+		}
+		std::sort(keyed.begin(), keyed.end(), [](auto const& a, auto const& b) {
+			return a.first < b.first;
+		});
+		m_stuff.clear();
+		for (auto& [_, f] : keyed) {
+			if (m_stuff.empty() || !(m_stuff.back() == f)) {
+				m_stuff.push_back(std::move(f));
+			}
+		}
+
+		auto intern = [this](std::string const& name) {
+			return this->intern(name);
+		};
+		for (size_t i = 0; i < m_stuff.size(); i++) {
+			auto& f = m_stuff[i];
+			auto index = static_cast<int>(i);
+			auto ret = this->intern(f.return_type);
+			if (ret >= static_cast<int>(m_ret.size())) {
+				m_ret.resize(ret + 1, -1);
+			}
+			if (m_ret[ret] == -1) {
+				m_ret[ret] = index;
+			}
+			auto pure = TypeBank::pureKey(f, intern);
+			auto inClass = TypeBank::classKey(f, intern);
+			m_static.try_emplace(TypeBank::withType(pure, f), index);
+			m_pure.try_emplace(std::move(pure), index);
+			m_exact.try_emplace(TypeBank::withType(inClass, f), index);
+			m_firstInClass.try_emplace(inClass, index);
+			m_lastInClass[std::move(inClass)] = index;
+		}
 	}
 
 	std::vector<Func> const& typeList() { return m_stuff; }
 
-	Ids getIDs(FunctionBegin const& fn, std::string const& parent) {
+	Ids getIDs(FunctionBegin const& fn, std::string const& parent) const {
 		Ids out;
+		if (m_stuff.empty()) return out;
 		Func in_f = TypeBank::makeFunc(fn, parent);
 
-		int i = 0;
-		for (auto f : m_stuff) {
-			if (out.ret == -1 && f.return_type == in_f.return_type) {
-				out.ret = i;
-			}
+		auto lookup = [this](std::string const& name) {
+			return this->lookup(name);
+		};
 
-			if (out.func == -1) {
-				if (in_f.type == FuncType::Member) {
-					if (f == in_f) out.func = i;
-				} else if (in_f.type == FuncType::Structor) {
-					if (
-						f.return_type == in_f.return_type &&
-						f.class_name == in_f.class_name &&
-						f.is_const == in_f.is_const &&
-						f.parameter_types == in_f.parameter_types
-					) out.func = i;
-				} else {
-					if (
-						f.return_type == in_f.return_type &&
-						f.parameter_types == in_f.parameter_types &&
-						f.type == in_f.type
-					) out.func = i;
-				}
-			}
-
-			if (out.meta == -1 || out.member == -1) {
-				Func assume_member = f;
-				assume_member.type = FuncType::Member;
-
-				if (in_f == assume_member) {
-					out.meta = i;
-				} else if (out.func != -1) {
-					out.meta = out.func;
-				}
-			}
-
-			if (out.pure == -1 && f.return_type == in_f.return_type && f.parameter_types == in_f.parameter_types) {
-				out.pure = i;
-			}
+		// every id is the first function in the list matching in some way
+		auto ret = this->lookup(in_f.return_type);
+		out.ret = ret != -1 && ret < static_cast<int>(m_ret.size()) ? m_ret[ret] : -1;
+		out.pure = TypeBank::find(m_pure, TypeBank::pureKey(in_f, lookup));
+		if (in_f.type == FuncType::Member) {
+			out.func = TypeBank::find(m_exact, TypeBank::withType(TypeBank::classKey(in_f, lookup), in_f));
+		} else if (in_f.type == FuncType::Structor) {
+			out.func = TypeBank::find(m_firstInClass, TypeBank::classKey(in_f, lookup));
+		} else {
+			out.func = TypeBank::find(m_static, TypeBank::withType(TypeBank::pureKey(in_f, lookup), in_f));
+		}
 
-			if (out.ret != -1 && out.func != -1 && out.pure != -1)
-				break;
-			++i;
+		// the meta id depends on where a linear search for the ids above
+		// would stop, which is after all three were found (or at the end)
+		int last = out.ret != -1 && out.func != -1 && out.pure != -1
+			? std::max({ out.ret, out.func, out.pure })
+			: static_cast<int>(m_stuff.size()) - 1;
+		auto const& at = m_stuff[last];
+		if (
+			in_f.type == FuncType::Member &&
+			at.return_type == in_f.return_type &&
+			at.is_const == in_f.is_const &&
+			at.class_name == in_f.class_name &&
+			at.parameter_types == in_f.parameter_types
+		) {
+			out.meta = last;
+		} else if (out.func != -1) {
+			out.meta = out.func;
+		} else if (in_f.type == FuncType::Member) {
+			out.meta = TypeBank::find(m_lastInClass, TypeBank::classKey(in_f, lookup));
 		}
 
 		out.member = out.func;
@@ -163,18 +247,11 @@ class TypeBank {
 		return out;
 	}
 
-	int getPure(FunctionBegin const& fn, std::string const& parent) {
-		Func in_f = TypeBank::makeFunc(fn, parent);
-
-		int i = 0;
-		for (auto f : m_stuff) {
-			if (f.return_type == in_f.return_type && f.parameter_types == in_f.parameter_types) {
-				return i;
-			}
-			++i;
-		}
-
-		return -1;
+	int getPure(FunctionBegin const& fn, std::string const& parent) const {
+		auto lookup = [this](std::string const& name) {
+			return this->lookup(name);
+		};
+		return TypeBank::find(m_pure, TypeBank::pureKey(TypeBank::makeFunc(fn, parent), lookup));
 	}
 };
 }
\ No newline at end of file
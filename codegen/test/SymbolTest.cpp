@@ -0,0 +1,157 @@
+// Checks the lookups of the loader's SymbolMap against a plain binary search
+// over the table codegen generated, and times them.
+// Usage: CodegenSymbolTest [lookups]
+
+#include <SymbolMap.hpp>
+#include <Geode/GeneratedSymbols.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <optional>
+#include <random>
+#include <sstream>
+#include <string>
+
+static int g_failures = 0;
+
+static void check(bool cond, std::string const& what) {
+    if (!cond) {
+        std::cerr << "FAIL: " << what << std::endl;
+        g_failures++;
+    }
+}
+
+static std::string hex(uintptr_t offset) {
+    std::ostringstream stream;
+    stream << "0x" << std::hex << offset;
+    return stream.str();
+}
+
+// the last symbol at or before the offset, the slow way
+static std::optional<SymbolMap::Symbol> expected(uintptr_t offset) {
+    auto it = std::upper_bound(
+        GENERATED_SYMBOL_OFFSETS.begin(), GENERATED_SYMBOL_OFFSETS.end(), offset
+    );
+    if (it == GENERATED_SYMBOL_OFFSETS.begin()) return std::nullopt;
+    auto i = it - GENERATED_SYMBOL_OFFSETS.begin() - 1;
+    auto displacement = offset - *(it - 1);
+    if (displacement > SymbolMap::MAX_DISPLACEMENT) return std::nullopt;
+    return SymbolMap::Symbol { GENERATED_SYMBOL_NAMES[i], displacement,
+                               displacement > SymbolMap::APPROXIMATE_DISPLACEMENT };
+}
+
+static void compare(SymbolMap const& map, uintptr_t offset) {
+    auto found = map.find(offset);
+    auto want = expected(offset);
+    auto same = found.has_value() == want.has_value() &&
+        (!found ||
+         (found->m_name == want->m_name && found->m_displacement == want->m_displacement &&
+          found->m_approximate == want->m_approximate));
+    check(same, "lookup of " + hex(offset));
+}
+
+int main(int argc, char** argv) {
+    size_t lookups = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10'000'000;
+    auto const count = GENERATED_SYMBOL_OFFSETS.size();
+
+    check(
+        std::is_sorted(GENERATED_SYMBOL_OFFSETS.begin(), GENERATED_SYMBOL_OFFSETS.end()) &&
+            std::adjacent_find(GENERATED_SYMBOL_OFFSETS.begin(), GENERATED_SYMBOL_OFFSETS.end()) ==
+                GENERATED_SYMBOL_OFFSETS.end(),
+        "offsets are sorted and unique"
+    );
+
+    SymbolMap map(GENERATED_SYMBOL_OFFSETS.data(), GENERATED_SYMBOL_NAMES.data(), count);
+    check(map.size() == count, "size");
+    check(!SymbolMap().find(0x1000), "empty map finds nothing");
+
+    // every function, the addresses right around its start, and the last
+    // address before the next one
+    for (size_t i = 0; i < count; i++) {
+        auto offset = GENERATED_SYMBOL_OFFSETS[i];
+        auto found = map.find(offset);
+        check(
+            found && found->m_name == GENERATED_SYMBOL_NAMES[i] && found->m_displacement == 0,
+            std::string("start of ") + GENERATED_SYMBOL_NAMES[i]
+        );
+        compare(map, offset - 1);
+        compare(map, offset + 1);
+    }
+    if (count) {
+        check(!map.find(GENERATED_SYMBOL_OFFSETS[0] - 1), "before the first function");
+        auto last = GENERATED_SYMBOL_OFFSETS[count - 1];
+        compare(map, last + SymbolMap::MAX_DISPLACEMENT);
+        check(!map.find(last + SymbolMap::MAX_DISPLACEMENT + 1), "too far past the last function");
+        check(
+            map.describe(GENERATED_SYMBOL_OFFSETS[0] + 0x12) ==
+                std::string(GENERATED_SYMBOL_NAMES[0]) + "+0x12",
+            "describe"
+        );
+        check(
+            map.describe(last + 0x1234) == std::string("near ") + GENERATED_SYMBOL_NAMES[count - 1] + "+0x1234",
+            "describe approximate"
+        );
+    }
+
+    // every subset size, so that incomplete last levels of the tree are covered
+    for (size_t size = 0; size <= std::min<size_t>(count, 64); size++) {
+        SymbolMap small(GENERATED_SYMBOL_OFFSETS.data(), GENERATED_SYMBOL_NAMES.data(), size);
+        for (size_t i = 0; i < size; i++) {
+            auto offset = GENERATED_SYMBOL_OFFSETS[i];
+            auto found = small.find(offset + 1);
+            check(found && found->m_name == GENERATED_SYMBOL_NAMES[i], "subset lookup");
+        }
+        if (size) {
+            auto found = small.find(GENERATED_SYMBOL_OFFSETS[size - 1] + 0x2000);
+            check(
+                found && found->m_name == GENERATED_SYMBOL_NAMES[size - 1] && found->m_approximate,
+                "past the subset"
+            );
+            check(
+                !small.find(GENERATED_SYMBOL_OFFSETS[size - 1] + SymbolMap::MAX_DISPLACEMENT + 1),
+                "too far past the subset"
+            );
+        }
+    }
+
+    if (!count) {
+        std::cout << "no symbols for this platform" << std::endl;
+        return g_failures ? EXIT_FAILURE : EXIT_SUCCESS;
+    }
+
+    std::mt19937_64 rng(0);
+    std::uniform_int_distribution<uintptr_t> dist(
+        0, GENERATED_SYMBOL_OFFSETS[count - 1] + SymbolMap::MAX_DISPLACEMENT * 2
+    );
+    std::vector<uintptr_t> addresses(1 << 16);
+    for (auto& address : addresses) {
+        address = dist(rng);
+        compare(map, address);
+    }
+
+    auto time = [&](char const* name, auto&& func) {
+        size_t sum = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < lookups; i++) {
+            sum += func(addresses[i & (addresses.size() - 1)]);
+        }
+        auto elapsed = std::chrono::duration<double, std::nano>(
+            std::chrono::steady_clock::now() - start
+        );
+        std::cout << name << ": " << elapsed.count() / lookups << " ns per lookup (" << sum << ")"
+                  << std::endl;
+    };
+    time("SymbolMap", [&](uintptr_t address) {
+        auto found = map.find(address);
+        return found ? found->m_displacement : 0;
+    });
+    time("std::upper_bound", [&](uintptr_t address) {
+        auto found = expected(address);
+        return found ? found->m_displacement : 0;
+    });
+
+    std::cout << count << " symbols, " << (g_failures ? "FAILED" : "passed") << std::endl;
+    return g_failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
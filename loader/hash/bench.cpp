@@ -0,0 +1,164 @@
+// Compares the hashing in hash.hpp against the picosha based functions it
+// replaced, both for speed and for producing the same hashes.
+// Usage: GeodeHashBench [size in MB]
+
+#include "hash.hpp"
+#include "picosha2.h"
+#include "picosha3.h"
+
+#include <chrono>
+#include <iostream>
+#include <random>
+
+static std::string oldSHA3_256(ghc::filesystem::path const& path) {
+    auto sha3_256 = picosha3::get_sha3_generator<256>();
+    std::ifstream file(path, std::ios::binary);
+    return sha3_256.get_hex_string(file);
+}
+
+static std::string oldSHA256(ghc::filesystem::path const& path) {
+    std::vector<uint8_t> hash(picosha2::k_digest_size);
+    std::ifstream file(path, std::ios::binary);
+    picosha2::hash256(file, hash.begin(), hash.end());
+    return picosha2::bytes_to_hex_string(hash.begin(), hash.end());
+}
+
+// the SHA extension kernel is picked whenever the CPU has it, so check the
+// fallback separately by padding the message by hand
+static std::string portableSHA256(ghc::filesystem::path const& path) {
+    std::ifstream file(path, std::ios::binary);
+    std::vector<uint8_t> message((std::istreambuf_iterator<char>(file)), {});
+    auto bits = static_cast<uint64_t>(message.size()) * 8;
+    message.push_back(0x80);
+    while (message.size() % 64 != 56) {
+        message.push_back(0);
+    }
+    for (int i = 7; i >= 0; i--) {
+        message.push_back(static_cast<uint8_t>(bits >> (i * 8)));
+    }
+
+    uint32_t state[8] = {
+        0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+        0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19,
+    };
+    digest::detail::sha256Portable(state, message.data(), message.size() / 64);
+    uint8_t out[32];
+    for (size_t i = 0; i < 8; i++) {
+        out[i * 4] = static_cast<uint8_t>(state[i] >> 24);
+        out[i * 4 + 1] = static_cast<uint8_t>(state[i] >> 16);
+        out[i * 4 + 2] = static_cast<uint8_t>(state[i] >> 8);
+        out[i * 4 + 3] = static_cast<uint8_t>(state[i]);
+    }
+    return digest::toHex(out, sizeof(out));
+}
+
+static void writeRandom(ghc::filesystem::path const& path, size_t size, std::mt19937& rng) {
+    std::vector<char> data(size);
+    for (auto& c : data) {
+        c = static_cast<char>(rng());
+    }
+    std::ofstream(path, std::ios::binary).write(data.data(), data.size());
+}
+
+template <class F>
+static double time(F&& func) {
+    auto start = std::chrono::steady_clock::now();
+    func();
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start)
+        .count();
+}
+
+int main(int argc, char** argv) {
+    size_t megabytes = argc > 1 ? std::stoul(argv[1]) : 64;
+    auto dir = ghc::filesystem::temp_directory_path() / "geode-hash-bench";
+    ghc::filesystem::create_directories(dir);
+    std::mt19937 rng(1234);
+
+    // every length around the block boundaries of both algorithms
+    int mismatches = 0;
+    for (size_t size = 0; size <= 300; size++) {
+        auto path = dir / "small";
+        writeRandom(path, size, rng);
+        auto check = [&](char const* name, std::string const& a, std::string const& b) {
+            if (a != b) {
+                std::cout << name << " mismatch at " << size << " bytes: " << a << " != " << b
+                          << "\n";
+                mismatches++;
+            }
+        };
+        check("SHA-256", calculateSHA256(path), oldSHA256(path));
+        check("SHA-256 (portable)", portableSHA256(path), oldSHA256(path));
+        // picosha3 pads these lengths wrong, the vectors below cover them
+        if (size % digest::SHA3_256::BLOCK_SIZE != digest::SHA3_256::BLOCK_SIZE - 1) {
+            check("SHA3-256", calculateSHA3_256(path), oldSHA3_256(path));
+        }
+    }
+
+    // known answers for "a" repeated, from Python's hashlib
+    struct Vector {
+        size_t m_length;
+        char const* m_sha256;
+        char const* m_sha3;
+    };
+    for (auto& vector : {
+             Vector { 0, "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855",
+                      "a7ffc6f8bf1ed76651c14756a061d662f580ff4de43b49fa82d80a4b80f8434a" },
+             Vector { 135, "dfa58dfd72f3c7080d0249a7758fd3636872f63fa24b18473ed36f031e248347",
+                      "8094bb53c44cfb1e67b7c30447f9a1c33696d2463ecc1d9c92538913392843c9" },
+             Vector { 136, "6f0e44b9ce4ea61d52a3479c10f60ef916937f799f11964b7f1c7771063905c4",
+                      "3fc5559f14db8e453a0a3091edbd2bc25e11528d81c66fa570a4efdcc2695ee1" },
+             Vector { 200, "c2a908d98f5df987ade41b5fce213067efbcc21ef2240212a41e54b5e7c28ae5",
+                      "cce34485baf2bf2aca99b94833892a4f52896d3d153f7b840cc4f9fe695f1387" },
+         }) {
+        auto size = vector.m_length;
+        auto path = dir / "vector";
+        std::ofstream(path, std::ios::binary) << std::string(size, 'a');
+        if (calculateSHA256(path) != vector.m_sha256 || calculateSHA3_256(path) != vector.m_sha3) {
+            std::cout << "wrong hash for " << size << " bytes\n";
+            mismatches++;
+        }
+    }
+    std::cout << "SHA extensions: " <<
+#ifdef GEODE_HASH_X86
+        (digest::detail::hasSHAExtensions() ? "yes" : "no")
+#else
+        "not x86"
+#endif
+              << "\n";
+
+    auto big = dir / "big";
+    writeRandom(big, megabytes << 20, rng);
+    std::cout << "hashing " << megabytes << " MB\n";
+
+    auto bench = [&](char const* name, auto oldFunc, auto newFunc) {
+        std::string oldHash, newHash;
+        auto oldTime = time([&] { oldHash = oldFunc(big); });
+        auto newTime = time([&] { newHash = newFunc(big); });
+        if (oldHash != newHash) {
+            mismatches++;
+        }
+        std::cout << name << ": old " << oldTime << " ms, new " << newTime << " ms ("
+                  << oldTime / newTime << "x)" << (oldHash == newHash ? "" : " MISMATCH")
+                  << "\n";
+    };
+    bench("SHA-256", oldSHA256, calculateSHA256);
+    bench("SHA3-256", oldSHA3_256, calculateSHA3_256);
+
+    // many small files, like the loader resources
+    std::vector<ghc::filesystem::path> files;
+    for (size_t i = 0; i < 200; i++) {
+        files.push_back(dir / ("res" + std::to_string(i)));
+        writeRandom(files.back(), 64 << 10, rng);
+    }
+    auto sequential = time([&] {
+        for (auto& file : files) {
+            (void)oldSHA256(file);
+        }
+    });
+    auto parallel = time([&] { (void)calculateHashes(files, calculateSHA256); });
+    std::cout << "200 x 64 KB SHA-256: old sequential " << sequential << " ms, new parallel "
+              << parallel << " ms (" << std::thread::hardware_concurrency() << " threads)\n";
+
+    ghc::filesystem::remove_all(dir);
+    return mismatches ? 1 : 0;
+}
@@ -0,0 +1,401 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+    #define GEODE_HASH_X86
+    #include <immintrin.h>
+    #ifdef _MSC_VER
+        #include <intrin.h>
+    #else
+        #include <cpuid.h>
+    #endif
+#endif
+
+#if defined(GEODE_HASH_X86) && (defined(__GNUC__) || defined(__clang__))
+    #define GEODE_HASH_TARGET_SHA __attribute__((target("sha,sse4.1,ssse3")))
+#else
+    #define GEODE_HASH_TARGET_SHA
+#endif
+
+/**
+ * Incremental SHA-256 and SHA3-256. Both consume whole blocks at a time
+ * instead of a byte at a time like picosha, and SHA-256 uses the SHA
+ * extensions on x86 CPUs that have them
+ */
+namespace digest {
+    inline std::string toHex(uint8_t const* data, size_t size) {
+        static constexpr char digits[] = "0123456789abcdef";
+        std::string hex(size * 2, '\0');
+        for (size_t i = 0; i < size; i++) {
+            hex[i * 2] = digits[data[i] >> 4];
+            hex[i * 2 + 1] = digits[data[i] & 0xf];
+        }
+        return hex;
+    }
+
+    namespace detail {
+        inline uint32_t rotr(uint32_t x, int n) {
+            return (x >> n) | (x << (32 - n));
+        }
+
+        inline uint64_t rotl(uint64_t x, int n) {
+            return n ? (x << n) | (x >> (64 - n)) : x;
+        }
+
+        alignas(16) inline constexpr uint32_t SHA256_K[64] = {
+            0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4,
+            0xab1c5ed5, 0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe,
+            0x9bdc06a7, 0xc19bf174, 0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f,
+            0x4a7484aa, 0x5cb0a9dc, 0x76f988da, 0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7,
+            0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967, 0x27b70a85, 0x2e1b2138, 0x4d2c6dfc,
+            0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85, 0xa2bfe8a1, 0xa81a664b,
+            0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070, 0x19a4c116,
+            0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+            0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7,
+            0xc67178f2,
+        };
+
+        inline void sha256Portable(uint32_t state[8], uint8_t const* data, size_t blocks) {
+            for (; blocks; blocks--, data += 64) {
+                uint32_t w[64];
+                for (size_t i = 0; i < 16; i++) {
+                    w[i] = (uint32_t(data[i * 4]) << 24) | (uint32_t(data[i * 4 + 1]) << 16) |
+                        (uint32_t(data[i * 4 + 2]) << 8) | uint32_t(data[i * 4 + 3]);
+                }
+                for (size_t i = 16; i < 64; i++) {
+                    auto s0 = rotr(w[i - 15], 7) ^ rotr(w[i - 15], 18) ^ (w[i - 15] >> 3);
+                    auto s1 = rotr(w[i - 2], 17) ^ rotr(w[i - 2], 19) ^ (w[i - 2] >> 10);
+                    w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+                }
+
+                auto a = state[0], b = state[1], c = state[2], d = state[3];
+                auto e = state[4], f = state[5], g = state[6], h = state[7];
+                for (size_t i = 0; i < 64; i++) {
+                    auto s1 = rotr(e, 6) ^ rotr(e, 11) ^ rotr(e, 25);
+                    auto ch = (e & f) ^ (~e & g);
+                    auto t1 = h + s1 + ch + SHA256_K[i] + w[i];
+                    auto s0 = rotr(a, 2) ^ rotr(a, 13) ^ rotr(a, 22);
+                    auto maj = (a & b) ^ (a & c) ^ (b & c);
+                    auto t2 = s0 + maj;
+                    h = g;
+                    g = f;
+                    f = e;
+                    e = d + t1;
+                    d = c;
+                    c = b;
+                    b = a;
+                    a = t1 + t2;
+                }
+                state[0] += a;
+                state[1] += b;
+                state[2] += c;
+                state[3] += d;
+                state[4] += e;
+                state[5] += f;
+                state[6] += g;
+                state[7] += h;
+            }
+        }
+
+#ifdef GEODE_HASH_X86
+        inline bool hasSHAExtensions() {
+            static bool const supported = [] {
+    #ifdef _MSC_VER
+                int regs[4];
+                __cpuid(regs, 0);
+                if (regs[0] < 7) return false;
+                __cpuid(regs, 1);
+                bool sse = (regs[2] & (1 << 9)) && (regs[2] & (1 << 19));
+                __cpuidex(regs, 7, 0);
+                return sse && (regs[1] & (1 << 29));
+    #else
+                unsigned int eax, ebx, ecx, edx;
+                if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx)) return false;
+                bool sse = (ecx & bit_SSSE3) && (ecx & bit_SSE4_1);
+                if (!__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx)) return false;
+                return sse && (ebx & (1 << 29));
+    #endif
+            }();
+            return supported;
+        }
+
+        GEODE_HASH_TARGET_SHA
+        inline void sha256SHANI(uint32_t state[8], uint8_t const* data, size_t blocks) {
+            auto const mask = _mm_set_epi64x(0x0c0d0e0f08090a0bull, 0x0405060700010203ull);
+
+            // the instructions want the state as ABEF / CDGH
+            auto tmp = _mm_loadu_si128(reinterpret_cast<__m128i const*>(&state[0]));
+            auto state1 = _mm_loadu_si128(reinterpret_cast<__m128i const*>(&state[4]));
+            tmp = _mm_shuffle_epi32(tmp, 0xB1);
+            state1 = _mm_shuffle_epi32(state1, 0x1B);
+            auto state0 = _mm_alignr_epi8(tmp, state1, 8);
+            state1 = _mm_blend_epi16(state1, tmp, 0xF0);
+
+            for (; blocks; blocks--, data += 64) {
+                auto abef = state0;
+                auto cdgh = state1;
+
+                __m128i w[4];
+                for (int i = 0; i < 16; i++) {
+                    if (i < 4) {
+                        w[i] = _mm_shuffle_epi8(
+                            _mm_loadu_si128(reinterpret_cast<__m128i const*>(data + i * 16)), mask
+                        );
+                    }
+                    else {
+                        auto next = _mm_sha256msg1_epu32(w[i & 3], w[(i - 3) & 3]);
+                        next = _mm_add_epi32(next, _mm_alignr_epi8(w[(i - 1) & 3], w[(i - 2) & 3], 4));
+                        w[i & 3] = _mm_sha256msg2_epu32(next, w[(i - 1) & 3]);
+                    }
+                    auto msg = _mm_add_epi32(
+                        w[i & 3], _mm_load_si128(reinterpret_cast<__m128i const*>(&SHA256_K[i * 4]))
+                    );
+                    state1 = _mm_sha256rnds2_epu32(state1, state0, msg);
+                    state0 = _mm_sha256rnds2_epu32(state0, state1, _mm_shuffle_epi32(msg, 0x0E));
+                }
+
+                state0 = _mm_add_epi32(state0, abef);
+                state1 = _mm_add_epi32(state1, cdgh);
+            }
+
+            tmp = _mm_shuffle_epi32(state0, 0x1B);
+            state1 = _mm_shuffle_epi32(state1, 0xB1);
+            state0 = _mm_blend_epi16(tmp, state1, 0xF0);
+            state1 = _mm_alignr_epi8(state1, tmp, 8);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(&state[0]), state0);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(&state[4]), state1);
+        }
+#endif
+
+        inline void sha256Blocks(uint32_t state[8], uint8_t const* data, size_t blocks) {
+#ifdef GEODE_HASH_X86
+            if (hasSHAExtensions()) {
+                return sha256SHANI(state, data, blocks);
+            }
+#endif
+            sha256Portable(state, data, blocks);
+        }
+
+        inline constexpr uint64_t KECCAK_RC[24] = {
+            0x0000000000000001, 0x0000000000008082, 0x800000000000808a, 0x8000000080008000,
+            0x000000000000808b, 0x0000000080000001, 0x8000000080008081, 0x8000000000008009,
+            0x000000000000008a, 0x0000000000000088, 0x0000000080008009, 0x000000008000000a,
+            0x000000008000808b, 0x800000000000008b, 0x8000000000008089, 0x8000000000008003,
+            0x8000000000008002, 0x8000000000000080, 0x000000000000800a, 0x800000008000000a,
+            0x8000000080008081, 0x8000000000008080, 0x0000000080000001, 0x8000000080008008,
+        };
+        // unrolled so every lane stays in a register, indexed as x + 5 * y
+        inline void keccakF1600(uint64_t st[25]) {
+            for (int round = 0; round < 24; round++) {
+                // theta
+                auto c0 = st[0] ^ st[5] ^ st[10] ^ st[15] ^ st[20];
+                auto c1 = st[1] ^ st[6] ^ st[11] ^ st[16] ^ st[21];
+                auto c2 = st[2] ^ st[7] ^ st[12] ^ st[17] ^ st[22];
+                auto c3 = st[3] ^ st[8] ^ st[13] ^ st[18] ^ st[23];
+                auto c4 = st[4] ^ st[9] ^ st[14] ^ st[19] ^ st[24];
+                auto d0 = c4 ^ rotl(c1, 1);
+                auto d1 = c0 ^ rotl(c2, 1);
+                auto d2 = c1 ^ rotl(c3, 1);
+                auto d3 = c2 ^ rotl(c4, 1);
+                auto d4 = c3 ^ rotl(c0, 1);
+                // rho & pi
+                uint64_t b[25];
+                b[0] = rotl(st[0] ^ d0, 0);
+                b[10] = rotl(st[1] ^ d1, 1);
+                b[20] = rotl(st[2] ^ d2, 62);
+                b[5] = rotl(st[3] ^ d3, 28);
+                b[15] = rotl(st[4] ^ d4, 27);
+                b[16] = rotl(st[5] ^ d0, 36);
+                b[1] = rotl(st[6] ^ d1, 44);
+                b[11] = rotl(st[7] ^ d2, 6);
+                b[21] = rotl(st[8] ^ d3, 55);
+                b[6] = rotl(st[9] ^ d4, 20);
+                b[7] = rotl(st[10] ^ d0, 3);
+                b[17] = rotl(st[11] ^ d1, 10);
+                b[2] = rotl(st[12] ^ d2, 43);
+                b[12] = rotl(st[13] ^ d3, 25);
+                b[22] = rotl(st[14] ^ d4, 39);
+                b[23] = rotl(st[15] ^ d0, 41);
+                b[8] = rotl(st[16] ^ d1, 45);
+                b[18] = rotl(st[17] ^ d2, 15);
+                b[3] = rotl(st[18] ^ d3, 21);
+                b[13] = rotl(st[19] ^ d4, 8);
+                b[14] = rotl(st[20] ^ d0, 18);
+                b[24] = rotl(st[21] ^ d1, 2);
+                b[9] = rotl(st[22] ^ d2, 61);
+                b[19] = rotl(st[23] ^ d3, 56);
+                b[4] = rotl(st[24] ^ d4, 14);
+                // chi
+                st[0] = b[0] ^ (~b[1] & b[2]);
+                st[1] = b[1] ^ (~b[2] & b[3]);
+                st[2] = b[2] ^ (~b[3] & b[4]);
+                st[3] = b[3] ^ (~b[4] & b[0]);
+                st[4] = b[4] ^ (~b[0] & b[1]);
+                st[5] = b[5] ^ (~b[6] & b[7]);
+                st[6] = b[6] ^ (~b[7] & b[8]);
+                st[7] = b[7] ^ (~b[8] & b[9]);
+                st[8] = b[8] ^ (~b[9] & b[5]);
+                st[9] = b[9] ^ (~b[5] & b[6]);
+                st[10] = b[10] ^ (~b[11] & b[12]);
+                st[11] = b[11] ^ (~b[12] & b[13]);
+                st[12] = b[12] ^ (~b[13] & b[14]);
+                st[13] = b[13] ^ (~b[14] & b[10]);
+                st[14] = b[14] ^ (~b[10] & b[11]);
+                st[15] = b[15] ^ (~b[16] & b[17]);
+                st[16] = b[16] ^ (~b[17] & b[18]);
+                st[17] = b[17] ^ (~b[18] & b[19]);
+                st[18] = b[18] ^ (~b[19] & b[15]);
+                st[19] = b[19] ^ (~b[15] & b[16]);
+                st[20] = b[20] ^ (~b[21] & b[22]);
+                st[21] = b[21] ^ (~b[22] & b[23]);
+                st[22] = b[22] ^ (~b[23] & b[24]);
+                st[23] = b[23] ^ (~b[24] & b[20]);
+                st[24] = b[24] ^ (~b[20] & b[21]);
+                // iota
+                st[0] ^= KECCAK_RC[round];
+            }
+        }
+
+        inline uint64_t loadLE64(uint8_t const* data) {
+            uint64_t value = 0;
+            for (int i = 0; i < 8; i++) {
+                value |= uint64_t(data[i]) << (i * 8);
+            }
+            return value;
+        }
+    }
+
+    /**
+     * Shared buffering for hashes that consume fixed size blocks
+     */
+    template <class Self, size_t BlockSize>
+    class BlockHash {
+    protected:
+        std::array<uint8_t, BlockSize> m_buffer {};
+        size_t m_buffered = 0;
+        uint64_t m_length = 0;
+
+    public:
+        static constexpr size_t BLOCK_SIZE = BlockSize;
+
+        void update(uint8_t const* data, size_t size) {
+            m_length += size;
+            if (m_buffered) {
+                auto take = std::min(size, BlockSize - m_buffered);
+                std::memcpy(m_buffer.data() + m_buffered, data, take);
+                m_buffered += take;
+                data += take;
+                size -= take;
+                if (m_buffered < BlockSize) {
+                    return;
+                }
+                static_cast<Self*>(this)->blocks(m_buffer.data(), 1);
+                m_buffered = 0;
+            }
+            if (size >= BlockSize) {
+                static_cast<Self*>(this)->blocks(data, size / BlockSize);
+                data += size / BlockSize * BlockSize;
+                size %= BlockSize;
+            }
+            std::memcpy(m_buffer.data(), data, size);
+            m_buffered = size;
+        }
+
+        void update(void const* data, size_t size) {
+            this->update(static_cast<uint8_t const*>(data), size);
+        }
+    };
+
+    class SHA256 : public BlockHash<SHA256, 64> {
+    protected:
+        uint32_t m_state[8] = {
+            0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+            0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19,
+        };
+
+        friend class BlockHash<SHA256, 64>;
+
+        void blocks(uint8_t const* data, size_t count) {
+            detail::sha256Blocks(m_state, data, count);
+        }
+
+    public:
+        using BlockHash::update;
+
+        /**
+         * Pad the message and get the digest. The hasher can't be used
+         * afterwards
+         */
+        std::array<uint8_t, 32> finish() {
+            auto bits = m_length * 8;
+            uint8_t pad[72] = { 0x80 };
+            auto padSize = (m_buffered < 56 ? 56 : 120) - m_buffered;
+            for (int i = 0; i < 8; i++) {
+                pad[padSize + i] = static_cast<uint8_t>(bits >> (56 - i * 8));
+            }
+            this->update(pad, padSize + 8);
+
+            std::array<uint8_t, 32> digest;
+            for (size_t i = 0; i < 8; i++) {
+                digest[i * 4] = static_cast<uint8_t>(m_state[i] >> 24);
+                digest[i * 4 + 1] = static_cast<uint8_t>(m_state[i] >> 16);
+                digest[i * 4 + 2] = static_cast<uint8_t>(m_state[i] >> 8);
+                digest[i * 4 + 3] = static_cast<uint8_t>(m_state[i]);
+            }
+            return digest;
+        }
+
+        std::string finishHex() {
+            auto digest = this->finish();
+            return toHex(digest.data(), digest.size());
+        }
+    };
+
+    class SHA3_256 : public BlockHash<SHA3_256, 136> {
+    protected:
+        uint64_t m_state[25] = {};
+
+        friend class BlockHash<SHA3_256, 136>;
+
+        void blocks(uint8_t const* data, size_t count) {
+            for (; count; count--, data += BLOCK_SIZE) {
+                for (size_t i = 0; i < BLOCK_SIZE / 8; i++) {
+                    m_state[i] ^= detail::loadLE64(data + i * 8);
+                }
+                detail::keccakF1600(m_state);
+            }
+        }
+
+    public:
+        using BlockHash::update;
+
+        /**
+         * Pad the message and get the digest. The hasher can't be used
+         * afterwards
+         */
+        std::array<uint8_t, 32> finish() {
+            std::array<uint8_t, BLOCK_SIZE> pad {};
+            auto padSize = BLOCK_SIZE - m_buffered;
+            pad[0] = 0x06;
+            pad[padSize - 1] |= 0x80;
+            this->update(pad.data(), padSize);
+
+            std::array<uint8_t, 32> digest;
+            for (size_t i = 0; i < digest.size(); i++) {
+                digest[i] = static_cast<uint8_t>(m_state[i / 8] >> (i % 8 * 8));
+            }
+            return digest;
+        }
+
+        std::string finishHex() {
+            auto digest = this->finish();
+            return toHex(digest.data(), digest.size());
+        }
+    };
+}
@@ -1,27 +1,69 @@
 #pragma once
 
-#include <string>
+#include "digest.hpp"
+
+#include <atomic>
 #include <fstream>
-#include <ciso646>
-#include "picosha3.h"
-#include "picosha2.h"
-#include <vector>
 #include <fs/filesystem.hpp>
+#include <string>
+#include <thread>
+#include <vector>
 
-static std::string calculateSHA3_256(ghc::filesystem::path const& path) {
-    std::vector<uint8_t> s(picosha3::bits_to_bytes(256));
-    auto sha3_256 = picosha3::get_sha3_generator<256>();
+// files are read in chunks this big instead of through stream iterators
+static constexpr size_t HASH_READ_CHUNK = 1 << 20;
+
+template <class Hasher>
+static std::string calculateDigest(ghc::filesystem::path const& path) {
     std::ifstream file(path, std::ios::binary);
-    return sha3_256.get_hex_string(file);
+    if (!file.is_open()) {
+        return "";
+    }
+    Hasher hasher;
+    std::vector<char> buffer(HASH_READ_CHUNK);
+    while (file) {
+        file.read(buffer.data(), buffer.size());
+        hasher.update(buffer.data(), static_cast<size_t>(file.gcount()));
+    }
+    return hasher.finishHex();
+}
+
+static std::string calculateSHA3_256(ghc::filesystem::path const& path) {
+    return calculateDigest<digest::SHA3_256>(path);
 }
 
 static std::string calculateSHA256(ghc::filesystem::path const& path) {
-    std::vector<uint8_t> hash(picosha2::k_digest_size);
-    std::ifstream file(path, std::ios::binary);
-    picosha2::hash256(file, hash.begin(), hash.end());
-    return picosha2::bytes_to_hex_string(hash.begin(), hash.end());
+    return calculateDigest<digest::SHA256>(path);
 }
 
 static std::string calculateHash(ghc::filesystem::path const& path) {
     return calculateSHA3_256(path);
 }
+
+/**
+ * Hash many files at once, spread over all cores
+ * @param hash One of the functions above
+ * @returns The hashes in the same order as the paths
+ */
+static std::vector<std::string> calculateHashes(
+    std::vector<ghc::filesystem::path> const& paths,
+    std::string (*hash)(ghc::filesystem::path const&) = calculateHash
+) {
+    std::vector<std::string> hashes(paths.size());
+    std::atomic_size_t next = 0;
+    auto work = [&]() {
+        for (auto i = next++; i < paths.size(); i = next++) {
+            hashes[i] = hash(paths[i]);
+        }
+    };
+
+    auto threadCount = std::min<size_t>(std::thread::hardware_concurrency(), paths.size());
+    std::vector<std::thread> threads;
+    for (size_t i = 1; i < threadCount; i++) {
+        threads.emplace_back(work);
+    }
+    work();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    return hashes;
+}
@@ -4,6 +4,8 @@
 #include "modify/InternalMacros.hpp"
 
 #include <Geode/DefaultInclude.hpp>
+// every class; mods that only modify a few build faster by including
+// Geode/modify/<Class>.hpp for each of them instead
 #include <Geode/GeneratedModify.hpp>
 
 using namespace geode::modifier;
\ No newline at end of file
@@ -10,3 +10,4 @@
 #include "utils/file.hpp"
 #include "utils/general.hpp"
 #include "utils/timer.hpp"
+#include "utils/trace.hpp"
@@ -874,7 +874,9 @@ public:
         CCNode* getChildByID(std::string const& id);
 
         /**
-         * Get a child by its string ID. Recursively searches all the children
+         * Get a child by its string ID. Recursively searches all the children.
+         * Both lookups use an index of the children that is rebuilt after
+         * they change, so they don't walk the tree every time
          * @param id ID of the child
          * @returns The child, or nullptr if none was found
          */
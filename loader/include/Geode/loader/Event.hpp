@@ -16,6 +16,17 @@ namespace geode {
     };
 
     struct GEODE_DLL EventListenerProtocol {
+        /**
+         * Mod that created this listener. Its listeners are unregistered
+         * when it's unloaded
+         */
+        Mod* m_owner = Mod::get();
+        /**
+         * Set on listeners heap-allocated by helpers like listenForIPC,
+         * which the loader deletes when their owner is unloaded
+         */
+        bool m_autoDelete = false;
+
         virtual void enable();
         virtual void disable();
         virtual ListenerResult passThrough(Event*) = 0;
@@ -99,6 +110,13 @@ namespace geode {
     public:
         void postFrom(Mod* sender);
 
+        /**
+         * Unregister every listener owned by a mod, deleting the ones
+         * marked as auto-delete
+         * @returns Number of listeners removed
+         */
+        static size_t removeListenersOwnedBy(Mod* mod);
+
         inline void post() {
             postFrom(Mod::get());
         }
@@ -70,9 +70,9 @@ namespace geode {
     template<class = void>
     std::monostate listenForIPC(std::string const& messageID, nlohmann::json(*callback)(IPCEvent*)) {
         Loader::get()->scheduleOnModLoad(getMod(), [=]() {
-            new EventListener(
+            (new EventListener(
                 callback, IPCFilter(getMod()->getID(), messageID)
-            );
+            ))->m_autoDelete = true;
         });
         return std::monostate();
     }
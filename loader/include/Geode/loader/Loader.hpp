@@ -6,11 +6,22 @@
 #include <mutex>
 #include <atomic>
 #include "../utils/Result.hpp"
+#include "../utils/general.hpp"
 #include "ModInfo.hpp"
+#include <optional>
+#include <span>
+#include <string_view>
 
 namespace geode {
     using ScheduledFunction = std::function<void GEODE_CALL(void)>;
 
+    /**
+     * Dense handle to a mod in the loader's registry. Mods are never
+     * removed from the registry, so an index stays valid for as long
+     * as the loader exists
+     */
+    using ModIndex = size_t;
+
     struct InvalidGeodeFile {
         ghc::filesystem::path m_path;
         std::string m_reason;
@@ -21,9 +32,11 @@ namespace geode {
         std::vector<ghc::filesystem::path> m_modSearchDirectories;
         std::vector<ModInfo> m_modsToLoad;
         std::vector<InvalidGeodeFile> m_invalidMods;
-        std::unordered_map<std::string, Mod*> m_mods;
+        std::vector<Mod*> m_mods;
+        utils::StringMap<ModIndex> m_modIndices;
         std::vector<ghc::filesystem::path> m_texturePaths;
-        std::vector<ScheduledFunction> m_scheduledFunctions;
+        // along with the mod that scheduled them, null for the loader
+        std::vector<std::pair<Mod*, ScheduledFunction>> m_scheduledFunctions;
         mutable std::mutex m_scheduledFunctionsMutex;
         bool m_isSetup = false;
         std::atomic_bool m_earlyLoadFinished = false;
@@ -37,6 +50,7 @@ namespace geode {
         friend void GEODE_CALL ::geode_implicit_load(Mod*);
 
         Result<Mod*> loadModFromInfo(ModInfo const& info);
+        Mod* findMod(std::string_view id) const;
 
     public:
         ~Loader();
@@ -58,11 +72,36 @@ namespace geode {
             bool recursive = true
         );
         Result<> refreshModsList();
-        bool isModInstalled(std::string const& id) const;
-        Mod* getInstalledMod(std::string const& id) const;
-        bool isModLoaded(std::string const& id) const;
-        Mod* getLoadedMod(std::string const& id) const;
-        std::vector<Mod*> getAllMods();
+        /**
+         * Load mods from files that were just installed, without
+         * rescanning every search directory like refreshModsList does.
+         * The files have to be parsed already, which can be done off
+         * the GD thread
+         * @returns The mods that were loaded
+         */
+        std::vector<Mod*> loadInstalledMods(
+            std::vector<std::pair<ghc::filesystem::path, Result<ModInfo>>> const& files
+        );
+        bool isModInstalled(std::string_view id) const;
+        Mod* getInstalledMod(std::string_view id) const;
+        bool isModLoaded(std::string_view id) const;
+        Mod* getLoadedMod(std::string_view id) const;
+        /**
+         * Get the registry index of a mod
+         * @returns The index, or std::nullopt if no mod with
+         * the ID has been found
+         */
+        std::optional<ModIndex> getModIndex(std::string_view id) const;
+        /**
+         * Get a mod by its registry index
+         * @returns The mod, or nullptr if the index is out of range
+         */
+        Mod* getModAt(ModIndex index) const;
+        /**
+         * Get every mod found by the loader, ordered by index. The span
+         * is invalidated when new mods are found
+         */
+        std::span<Mod* const> getAllMods() const;
         static Mod* getInternalMod();
         void updateAllDependencies();
         std::vector<InvalidGeodeFile> getFailedMods() const;
@@ -11,6 +11,7 @@
 #include "../external/json/json.hpp"
 #include "../utils/general.hpp"
 #include "../cocos/support/zip_support/ZipUtils.h"
+#include <array>
 #include <optional>
 #include <string_view>
 #include <type_traits>
@@ -67,6 +68,21 @@ namespace geode {
          * Whether the mod is loadable or not
          */
         bool m_resolved = false;
+        /**
+         * Whether unloading released the mod's resources, in which
+         * case they're added back when it's loaded again
+         */
+        bool m_resourcesFreed = false;
+        /**
+         * Whether adding the resources back is waiting in the GD thread
+         * queue. Unloading clears this so a stale load doesn't run
+         */
+        bool m_resourcesQueued = false;
+        /**
+         * Whether the mod's package has been deleted. Kept up to date
+         * by the loader so checking it doesn't hit the filesystem
+         */
+        bool m_uninstalled = false;
         /**
          * Mod temp directory name
          */
@@ -87,6 +103,11 @@ namespace geode {
          * Saved values
          */
         nlohmann::json m_saved;
+        /**
+         * Sprite names expanded at runtime by expandSpriteName,
+         * keyed by the unexpanded name
+         */
+        utils::StringMap<std::string> m_expandedSprites;
 
         /**
          * Load the platform binary
@@ -379,6 +400,10 @@ namespace geode {
          */
         std::vector<Dependency> getUnresolvedDependencies();
 
+        /**
+         * Prefix a sprite name with this mod's ID. The returned string
+         * is owned by the mod and stays valid for as long as it exists
+         */
         char const* expandSpriteName(char const* name);
 
         /**
@@ -404,9 +429,54 @@ namespace geode {
     }
 }
 
+#ifdef GEODE_MOD_ID
+
+namespace geode::detail {
+    template <size_t N>
+    struct SpriteLiteral {
+        char m_value[N];
+
+        constexpr SpriteLiteral(char const (&str)[N]) {
+            for (size_t i = 0; i < N; i++) {
+                m_value[i] = str[i];
+            }
+        }
+    };
+
+    template <size_t N, SpriteLiteral<N> Name>
+    struct ExpandedSprite {
+        static constexpr std::string_view ID = GEODE_MOD_ID;
+
+        static constexpr auto value = [] {
+            std::array<char, ID.size() + 1 + N> res {};
+            for (size_t i = 0; i < ID.size(); i++) {
+                res[i] = ID[i];
+            }
+            res[ID.size()] = '/';
+            for (size_t i = 0; i < N; i++) {
+                res[ID.size() + 1 + i] = Name.m_value[i];
+            }
+            return res;
+        }();
+    };
+}
+
+/**
+ * The mod ID is known at build time, so the expanded name is baked
+ * into the binary and using it costs nothing at runtime
+ */
+template <geode::detail::SpriteLiteral Name>
+constexpr char const* operator"" _spr() {
+    return geode::detail::ExpandedSprite<sizeof(Name.m_value), Name>::value.data();
+}
+
+#else
+
 inline char const* operator"" _spr(char const* str, size_t) {
     return geode::Mod::get()->expandSpriteName(str);
 }
 
+#endif
+
 // this header uses Mod
 #include "ModEvent.hpp"
@@ -57,18 +57,18 @@ namespace geode {
         std::string const& settingID, void (*callback)(T*)
     ) {
         Loader::get()->scheduleOnModLoad(getMod(), [=]() {
-            new EventListener(
+            (new EventListener(
                 callback, SettingChangedFilter<T>(getMod()->getID(), settingID)
-            );
+            ))->m_autoDelete = true;
         });
         return std::monostate();
     }
 
     static std::monostate listenForAllSettingChanges(void (*callback)(Setting*)) {
         Loader::get()->scheduleOnModLoad(getMod(), [=]() {
-            new EventListener(
+            (new EventListener(
                 callback, SettingChangedFilter(getMod()->getID())
-            );
+            ))->m_autoDelete = true;
         });
         return std::monostate();
     }
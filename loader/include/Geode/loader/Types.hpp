@@ -157,6 +157,7 @@ namespace geode {
     static constexpr std::string_view GEODE_RESOURCE_DIRECTORY = "resources";
     static constexpr std::string_view GEODE_CONFIG_DIRECTORY = "config";
     static constexpr std::string_view GEODE_TEMP_DIRECTORY = "temp";
+    static constexpr std::string_view GEODE_CACHE_DIRECTORY = "cache";
     static constexpr std::string_view GEODE_MOD_EXTENSION = ".geode";
     static constexpr std::string_view GEODE_INDEX_DIRECTORY = "index";
 
@@ -1,6 +1,8 @@
 #ifndef GEODE_CORE_META_STDCALL_HPP
 #define GEODE_CORE_META_STDCALL_HPP
 
+#include <utility>
+
 namespace geode::core::meta::x86 {
     template <class Ret, class... Args>
     class Stdcall {
@@ -11,9 +13,10 @@ namespace geode::core::meta::x86 {
         }
 
     public:
+        using Pointer = Ret(__stdcall*)(Args...);
+
         static Ret invoke(void* address, Args... all) {
-            Ret(__stdcall * raw)(Args...) = reinterpret_cast<decltype(raw)>(address);
-            return raw(all...);
+            return reinterpret_cast<Pointer>(address)(std::forward<Args>(all)...);
         }
 
         template <Ret (*detour)(Args...)>
@@ -3,6 +3,7 @@
 
 #include "common.hpp"
 
+#include <cstddef>
 #include <type_traits>
 #include <utility>
 
@@ -3,6 +3,9 @@
 #include "Traits.hpp"
 #include <cocos2d.h>
 #include <Geode/loader/Loader.hpp>
+#include <Geode/loader/Mod.hpp>
+#include <cstddef>
+#include <new>
 #include <vector>
 
 namespace cocos2d {
@@ -10,31 +13,123 @@ namespace cocos2d {
 }
 
 namespace geode::modifier {
+    /**
+     * Storage for fields that didn't fit in the inline storage of their
+     * container, from pools of a few sizes kept by the loader
+     */
+    GEODE_DLL void* allocateField(size_t size);
+    GEODE_DLL void deallocateField(void* field, size_t size);
+
+    /**
+     * Destroy the fields of a mod on every node, before unloading it
+     * @returns The number of fields destroyed
+     */
+    GEODE_DLL size_t destroyFieldsOwnedBy(Mod* mod);
+
     class FieldContainer {
     private:
-        std::vector<void*> m_containedFields;
-        std::vector<std::function<void(void*)>> m_destructorFunctions;
+        // in front of the data of every field. the fields of a node are a
+        // list, most recently added first
+        struct alignas(std::max_align_t) Field {
+            Field* m_next;
+            size_t m_index;
+            // size of the data after the header, aligned
+            size_t m_size;
+            void (*m_destructor)(void*);
+            // the mod whose code m_destructor is in
+            Mod* m_owner;
+
+            void* data() {
+                return this + 1;
+            }
+        };
+
+        // the fields of most nodes fit in here, so they're stored along with
+        // the rest of the node's metadata without allocating
+        static constexpr size_t INLINE_SIZE = 80;
+        alignas(std::max_align_t) std::byte m_inline[INLINE_SIZE];
+        size_t m_inlineUsed = 0;
+        Field* m_fields = nullptr;
+
+        bool isInline(Field* field) const {
+            auto bytes = reinterpret_cast<std::byte const*>(field);
+            return bytes >= m_inline && bytes < m_inline + INLINE_SIZE;
+        }
+
+        void destroy(Field* field) {
+            field->m_destructor(field->data());
+            if (!this->isInline(field)) {
+                deallocateField(field, sizeof(Field) + field->m_size);
+            }
+        }
 
     public:
+        FieldContainer() = default;
+        FieldContainer(FieldContainer const&) = delete;
+        FieldContainer& operator=(FieldContainer const&) = delete;
+
         ~FieldContainer() {
-            for (auto i = 0u; i < m_containedFields.size(); i++) {
-                m_destructorFunctions[i](m_containedFields[i]);
-                operator delete(m_containedFields[i]);
+            auto field = m_fields;
+            while (field) {
+                auto next = field->m_next;
+                this->destroy(field);
+                field = next;
+            }
+        }
+
+        bool hasFieldsOwnedBy(Mod* mod) const {
+            for (auto field = m_fields; field; field = field->m_next) {
+                if (field->m_owner == mod) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        // the space of inline fields isn't reused, but a mod is only
+        // unloaded once
+        size_t destroyFieldsOwnedBy(Mod* mod) {
+            size_t count = 0;
+            auto link = &m_fields;
+            while (auto field = *link) {
+                if (field->m_owner == mod) {
+                    *link = field->m_next;
+                    this->destroy(field);
+                    count++;
+                }
+                else {
+                    link = &field->m_next;
+                }
             }
+            return count;
         }
 
         void* getField(size_t index) {
-            if (m_containedFields.size() <= index) {
-                m_containedFields.resize(index + 1);
-                m_destructorFunctions.resize(index + 1);
+            // nodes only have the fields of a few classes, so this is faster
+            // than a map
+            for (auto field = m_fields; field; field = field->m_next) {
+                if (field->m_index == index) {
+                    return field->data();
+                }
             }
-            return m_containedFields.at(index);
+            return nullptr;
         }
 
-        void* setField(size_t index, size_t size, std::function<void(void*)> destructor) {
-            m_containedFields.at(index) = operator new(size);
-            m_destructorFunctions.at(index) = destructor;
-            return m_containedFields.at(index);
+        void* setField(size_t index, size_t size, void (*destructor)(void*), Mod* owner) {
+            // keep every field aligned for any type, like operator new would
+            auto aligned = (size + alignof(std::max_align_t) - 1) & ~(alignof(std::max_align_t) - 1);
+            auto total = sizeof(Field) + aligned;
+
+            void* block;
+            if (m_inlineUsed + total <= INLINE_SIZE) {
+                block = m_inline + m_inlineUsed;
+                m_inlineUsed += total;
+            }
+            else {
+                block = allocateField(total);
+            }
+            m_fields = new (block) Field { m_fields, index, aligned, destructor, owner };
+            return m_fields->data();
         }
 
         static FieldContainer* from(cocos2d::CCNode* node) {
@@ -89,7 +184,8 @@ namespace geode::modifier {
             auto offsetField = container->getField(index);
             if (!offsetField) {
                 offsetField = container->setField(
-                    index, sizeof(Parent) - sizeof(Base), &FieldIntermediate::fieldDestructor
+                    index, sizeof(Parent) - sizeof(Base), &FieldIntermediate::fieldDestructor,
+                    Mod::get()
                 );
 
                 FieldIntermediate::fieldConstructor(offsetField);
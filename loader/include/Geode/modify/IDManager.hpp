@@ -19,28 +19,43 @@ namespace geode {
         using Provider = void(GEODE_CALL*)(T*);
 
     protected:
-        std::unordered_map<std::string, Provider<cocos2d::CCNode>> m_providers;
+        struct ProviderEntry {
+            Provider<cocos2d::CCNode> m_provider;
+            Mod* m_owner;
+        };
+
+        std::unordered_map<std::string, ProviderEntry> m_providers;
+
+        void addProvider(std::string const& name, Provider<cocos2d::CCNode> fun, Mod* owner);
 
     public:
         static NodeIDs* get();
 
         template<IDProvidable T>
         void registerProvider(void(GEODE_CALL* fun)(T*)) {
-            m_providers.insert({
+            this->addProvider(
                 T::CLASS_NAME,
-                reinterpret_cast<Provider<cocos2d::CCNode>>(fun)
-            });
+                reinterpret_cast<Provider<cocos2d::CCNode>>(fun),
+                Mod::get()
+            );
         }
 
         template<IDProvidable T>
         bool provide(T* layer) const {
-            if (m_providers.count(T::CLASS_NAME)) {
-                m_providers.at(T::CLASS_NAME)(layer);
+            auto found = m_providers.find(T::CLASS_NAME);
+            if (found != m_providers.end()) {
+                found->second.m_provider(layer);
                 return true;
             }
             return false;
         }
 
+        /**
+         * Remove every provider registered by a mod
+         * @returns Number of providers removed
+         */
+        size_t removeProvidersOwnedBy(Mod* mod);
+
         // @note Because NodeIDs::provideFor(this) looks really neat
         template<IDProvidable T>
         static bool provideFor(T* layer) {
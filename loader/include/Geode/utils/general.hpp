@@ -7,6 +7,8 @@
 #include <iomanip>
 #include <sstream>
 #include <string>
+#include <string_view>
+#include <unordered_map>
 #include <vector>
 #include <fs/filesystem.hpp>
 
@@ -57,6 +59,22 @@ namespace geode {
             return geode::utils::hash(txt);
         }
 
+        /**
+         * Transparent hasher that lets maps keyed by std::string be
+         * looked up with a std::string_view or char const* without
+         * allocating a temporary string
+         */
+        struct StringHash {
+            using is_transparent = void;
+
+            size_t operator()(std::string_view str) const noexcept {
+                return std::hash<std::string_view>()(str);
+            }
+        };
+
+        template <class Value>
+        using StringMap = std::unordered_map<std::string, Value, StringHash, std::equal_to<>>;
+
         template <typename T>
         constexpr const T& clamp(const T& value, const T& minValue, const T& maxValue) {
             return value < minValue ? minValue : maxValue < value ? maxValue : value;
@@ -0,0 +1,125 @@
+#pragma once
+
+#include "Result.hpp"
+
+#include <Geode/DefaultInclude.hpp>
+#include <chrono>
+#include <fs/filesystem.hpp>
+#include <string>
+#include <string_view>
+
+namespace geode::utils::trace {
+    /**
+     * Check whether trace zones are currently being recorded
+     */
+    GEODE_DLL bool isEnabled();
+    /**
+     * Start or stop recording trace zones. Already recorded zones
+     * are kept until clear() is called
+     */
+    GEODE_DLL void setEnabled(bool enabled);
+    /**
+     * Drop every recorded zone
+     */
+    GEODE_DLL void clear();
+
+    /**
+     * Copy a zone name into storage owned by the loader, so it stays
+     * valid even if the mod that created it gets unloaded. Interning
+     * the same name twice returns the same pointer
+     */
+    GEODE_DLL char const* intern(std::string_view name);
+    /**
+     * Record a finished zone. Names must come from intern()
+     * @param start Start timestamp from now()
+     * @param duration Duration in nanoseconds
+     */
+    GEODE_DLL void record(char const* name, int64_t start, int64_t duration);
+
+    /**
+     * Get the recorded zones of every thread as a Chrome trace-event
+     * JSON document, viewable in chrome://tracing or Perfetto
+     */
+    GEODE_DLL std::string dump();
+    /**
+     * Write the recorded zones as a Chrome trace-event JSON file
+     */
+    GEODE_DLL Result<> save(ghc::filesystem::path const& path);
+    /**
+     * Write the recorded zones from a crash handler. Doesn't build the
+     * document in memory, and gives up instead of waiting if another
+     * thread is holding the lock of the trace
+     * @returns Whether the trace was written
+     */
+    GEODE_DLL bool saveAfterCrash(ghc::filesystem::path const& path);
+
+    inline int64_t now() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::steady_clock::now().time_since_epoch()
+        )
+            .count();
+    }
+
+    /**
+     * Records the time between its construction and destruction.
+     * When tracing is disabled this costs a single flag check
+     */
+    class Zone final {
+    private:
+        char const* m_name = nullptr;
+        int64_t m_start = 0;
+
+    public:
+        /**
+         * @param name Interned name, see intern() and GEODE_TRACE_ZONE
+         */
+        explicit Zone(char const* name) {
+            if (isEnabled()) {
+                m_name = name;
+                m_start = now();
+            }
+        }
+        /**
+         * Zone with a name built at runtime. The name is only
+         * interned if tracing is enabled
+         */
+        explicit Zone(std::string const& name) {
+            if (isEnabled()) {
+                m_name = intern(name);
+                m_start = now();
+            }
+        }
+        /**
+         * Zone named after a constant name and an argument, like the ID
+         * of a mod. Nothing is built unless tracing is enabled
+         */
+        Zone(std::string_view name, std::string_view arg) {
+            if (isEnabled()) {
+                std::string full;
+                full.reserve(name.size() + 1 + arg.size());
+                full.append(name).append(" ").append(arg);
+                m_name = intern(full);
+                m_start = now();
+            }
+        }
+        Zone(Zone const&) = delete;
+        Zone& operator=(Zone const&) = delete;
+
+        ~Zone() {
+            if (m_name) {
+                record(m_name, m_start, now() - m_start);
+            }
+        }
+    };
+}
+
+/**
+ * Trace the rest of the current scope under a constant name. The name
+ * is interned once per call site
+ */
+#define GEODE_TRACE_ZONE(name)                                                               \
+    static auto const GEODE_CONCAT(geodeTraceName_, __LINE__) =                             \
+        ::geode::utils::trace::intern(name);                                                \
+    ::geode::utils::trace::Zone GEODE_CONCAT(geodeTraceZone_, __LINE__)(                   \
+        GEODE_CONCAT(geodeTraceName_, __LINE__)                                             \
+    )
@@ -6,6 +6,8 @@
 #include "general.hpp"
 
 #include <fs/filesystem.hpp>
+#include <atomic>
+#include <memory>
 #include <mutex>
 
 namespace geode::utils::web {
@@ -42,6 +44,49 @@ namespace geode::utils::web {
         FileProgressCallback prog = nullptr
     );
 
+    struct HttpCacheStats {
+        /**
+         * Requests answered straight from the cache
+         */
+        size_t m_hits = 0;
+        /**
+         * Requests where the server confirmed the cached copy was still
+         * up-to-date (304 Not Modified)
+         */
+        size_t m_revalidations = 0;
+        /**
+         * Requests that downloaded the full response
+         */
+        size_t m_misses = 0;
+        size_t m_entries = 0;
+        /**
+         * Size of the cached responses in bytes
+         */
+        size_t m_size = 0;
+    };
+
+    /**
+     * Start caching GET responses on disk. Responses with an ETag,
+     * Last-Modified or Cache-Control max-age are stored, revalidated with
+     * conditional requests once stale, and served from the cache while fresh
+     * or when the server answers 304. Requests that send their own
+     * conditional headers bypass the cache. Nothing is cached until this is
+     * called
+     * @param directory Directory to keep the cached responses in
+     * @param maxSize Size in bytes past which the least recently used
+     * responses are evicted
+     */
+    GEODE_DLL Result<> enableCache(ghc::filesystem::path const& directory, size_t maxSize);
+    /**
+     * Stop using the HTTP cache. Cached responses are kept on disk
+     */
+    GEODE_DLL void disableCache();
+    /**
+     * Remove every cached response
+     */
+    GEODE_DLL void clearCache();
+    GEODE_DLL HttpCacheStats getCacheStats();
+
     /**
      * Synchronously fetch data from the internet and parse it as JSON
      * @param url URL to fetch
@@ -60,6 +105,7 @@ namespace geode::utils::web {
     }
 
     class SentAsyncWebRequest;
+    class WebLoop;
     template <class T>
     class AsyncWebResult;
     class AsyncWebResponse;
@@ -69,31 +115,47 @@ namespace geode::utils::web {
     using AsyncExpect = std::function<void(std::string const&)>;
     using AsyncThen = std::function<void(SentAsyncWebRequest&, byte_array const&)>;
     using AsyncCancelled = std::function<void(SentAsyncWebRequest&)>;
+    /**
+     * Receives the body of a request in chunks as they are downloaded.
+     * Return false to cancel the request
+     */
+    using AsyncStream = std::function<bool(uint8_t const* data, size_t size)>;
+    using AsyncDeliver = std::function<void(SentAsyncWebRequest&)>;
+    /**
+     * Converts the downloaded data in the networking thread, and returns the
+     * callback that hands the converted value over in the GD thread (or null
+     * if the conversion failed)
+     */
+    using AsyncConvertThen =
+        std::function<AsyncDeliver(SentAsyncWebRequest&, byte_array const&)>;
 
     /**
      * A handle to an in-progress sent asynchronous web request. Use this to
      * cancel the request / query information about it
      */
-    class SentAsyncWebRequest {
+    class SentAsyncWebRequest : public std::enable_shared_from_this<SentAsyncWebRequest> {
     private:
         std::string m_id;
         std::string m_url;
-        std::vector<AsyncThen> m_thens;
+        std::vector<AsyncConvertThen> m_thens;
         std::vector<AsyncExpect> m_expects;
         std::vector<AsyncProgress> m_progresses;
         std::vector<AsyncCancelled> m_cancelleds;
-        std::atomic<bool> m_paused = true;
+        std::atomic<bool> m_paused = false;
         std::atomic<bool> m_cancelled = false;
         std::atomic<bool> m_finished = false;
         std::atomic<bool> m_cleanedUp = false;
         mutable std::mutex m_mutex;
-        std::variant<std::monostate, std::ostream*, ghc::filesystem::path> m_target =
-            std::monostate();
+        std::variant<std::monostate, std::ostream*, ghc::filesystem::path, AsyncStream>
+            m_target = std::monostate();
         std::vector<std::string> m_httpHeaders;
+        size_t m_resumeFrom = 0;
+        bool m_failOnError = false;
 
         template <class T>
         friend class AsyncWebResult;
         friend class AsyncWebRequest;
+        friend class WebLoop;
 
         void pause();
         void resume();
@@ -132,13 +194,15 @@ namespace geode::utils::web {
     private:
         std::optional<std::string> m_joinID;
         std::string m_url;
-        AsyncThen m_then = nullptr;
+        AsyncConvertThen m_then = nullptr;
         AsyncExpect m_expect = nullptr;
         AsyncProgress m_progress = nullptr;
         AsyncCancelled m_cancelled = nullptr;
         bool m_sent = false;
-        std::variant<std::monostate, std::ostream*, ghc::filesystem::path> m_target;
+        std::variant<std::monostate, std::ostream*, ghc::filesystem::path, AsyncStream> m_target;
         std::vector<std::string> m_httpHeaders;
+        size_t m_resumeFrom = 0;
+        bool m_failOnError = false;
 
         template <class T>
         friend class AsyncWebResult;
@@ -170,6 +234,21 @@ namespace geode::utils::web {
          * Can be called more than once.
          */
         AsyncWebRequest& header(std::string const& header);
+        /**
+         * Only download the part of the body past an offset, for continuing
+         * an interrupted download. Files downloaded into are appended to
+         * instead of overwritten. Fails if the server doesn't support ranges
+         * @param offset Number of bytes already downloaded
+         * @returns Same AsyncWebRequest
+         */
+        AsyncWebRequest& resumeFrom(size_t offset);
+        /**
+         * Fail the request if the server responds with an HTTP error status,
+         * instead of handing the error page over as the response. The error
+         * passed to `expect` then includes the status code
+         * @returns Same AsyncWebRequest
+         */
+        AsyncWebRequest& failOnError(bool fail = true);
         /**
          * URL to fetch from the internet asynchronously
          * @param url URL of the data to download. Redirects will be
@@ -272,6 +351,17 @@ namespace geode::utils::web {
          * into `into`
          */
         AsyncWebResult<std::monostate> into(ghc::filesystem::path const& path);
+        /**
+         * Process the body in chunks as they arrive instead of buffering all
+         * of it in memory, for example to feed an incremental parser or a
+         * hasher. The handler runs in the networking thread, so it must not
+         * touch the UI
+         * @param handler Called with every chunk of the body. Return false to
+         * cancel the request
+         * @returns AsyncWebResult, where you can specify the `then` action for
+         * after the whole body has been received
+         */
+        AsyncWebResult<std::monostate> stream(AsyncStream handler);
         /**
          * Download into memory as a string
          * @returns AsyncWebResult, where you can specify the `then` action for
@@ -294,7 +384,8 @@ namespace geode::utils::web {
         /**
          * Download into memory as a custom type. The data will first be
          * downloaded into memory as a byte array, and then converted using
-         * the specified converter function
+         * the specified converter function. The converter runs in the
+         * networking thread, so it must not touch the UI
          * @param converter Function that converts the data from a byte array
          * to the desired type
          * @returns AsyncWebResult, where you can specify the `then` action for
@@ -309,14 +400,18 @@ namespace geode::utils::web {
     template <class T>
     AsyncWebRequest& AsyncWebResult<T>::then(std::function<void(T)> handle) {
         m_request.m_then = [converter = m_converter,
-                            handle](SentAsyncWebRequest& req, byte_array const& arr) {
+                            handle](SentAsyncWebRequest& req, byte_array const& arr) -> AsyncDeliver {
             auto conv = converter(arr);
-            if (conv) {
-                handle(conv.unwrap());
-            }
-            else {
+            if (!conv) {
                 req.error("Unable to convert value: " + conv.unwrapErr());
+                return nullptr;
             }
+            // shared so handing it over to the GD thread never copies the value
+            return [handle, value = std::make_shared<T>(std::move(conv.unwrap()))](
+                       SentAsyncWebRequest&
+                   ) {
+                handle(std::move(*value));
+            };
         };
         return m_request;
     }
@@ -324,14 +419,17 @@ namespace geode::utils::web {
     template <class T>
     AsyncWebRequest& AsyncWebResult<T>::then(std::function<void(SentAsyncWebRequest&, T)> handle) {
         m_request.m_then = [converter = m_converter,
-                            handle](SentAsyncWebRequest& req, byte_array const& arr) {
+                            handle](SentAsyncWebRequest& req, byte_array const& arr) -> AsyncDeliver {
             auto conv = converter(arr);
-            if (conv) {
-                handle(req, conv.value());
-            }
-            else {
-                req.error("Unable to convert value: " + conv.error());
+            if (!conv) {
+                req.error("Unable to convert value: " + conv.unwrapErr());
+                return nullptr;
             }
+            return [handle, value = std::make_shared<T>(std::move(conv.unwrap()))](
+                       SentAsyncWebRequest& req
+                   ) {
+                handle(req, std::move(*value));
+            };
         };
         return m_request;
     }
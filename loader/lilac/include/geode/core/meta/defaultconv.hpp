@@ -1,13 +1,18 @@
 #ifndef LILAC_CORE_META_DEFAULTCONV_HPP
 #define LILAC_CORE_META_DEFAULTCONV_HPP
 
+#include <utility>
+
 namespace lilac::meta {
     template <class Ret, class... Args>
     class DefaultConv {
     public:
+        // conventions the compiler supports give the function pointer type
+        // to call with, see FunctionPointer
+        using Pointer = Ret (*)(Args...);
+
         static Ret invoke(void* address, Args... all) {
-            Ret (*raw)(Args...) = reinterpret_cast<decltype(raw)>(address);
-            return raw(all...);
+            return reinterpret_cast<Pointer>(address)(std::forward<Args>(all)...);
         }
 
         template <Ret (*detour)(Args...)>
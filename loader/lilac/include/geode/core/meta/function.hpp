@@ -6,6 +6,7 @@
 #include "tuple.hpp"
 
 #include <type_traits>
+#include <utility>
 
 namespace lilac::meta {
     /* The Geode Function class wraps functions with unconventional
@@ -29,9 +30,37 @@ namespace lilac::meta {
         Function(const Pointer& addr) : addr(reinterpret_cast<void*>(addr)) {}
 
         decltype(auto) operator()(Args... all) const {
-            return MyConv::invoke(addr, all...);
+            // only an address, so making one for every call costs nothing
+            static_assert(sizeof(Function) == sizeof(void*) && std::is_trivially_copyable_v<Function>);
+            return MyConv::invoke(addr, std::forward<Args>(all)...);
         }
     };
+
+    template <class Func, template <class, class...> class Conv>
+    struct FunctionPointerImpl {
+        static_assert(always_false<Func>, "Not a valid function pointer!");
+    };
+
+    template <class Ret, class... Args, template <class, class...> class Conv>
+    struct FunctionPointerImpl<Ret(Args...), Conv> {
+        using type = typename Conv<Ret, Args...>::Pointer;
+
+        // calling through it has to be a plain indirect call for the
+        // bindings to be free
+        static_assert(std::is_pointer_v<type> && std::is_function_v<std::remove_pointer_t<type>>);
+    };
+
+    /* Function pointer type for a calling convention the compiler supports
+     * (DefaultConv, and Cdecl, Thiscall and Stdcall on x86). Casting an
+     * address to it and calling it compiles down to setting up the
+     * arguments and a call, so codegen uses it instead of Function for
+     * these conventions. Optcall and Membercall have to reorder the
+     * arguments, so they still go through Function, which builds a Tuple
+     * of the arguments for every call. There are no per-signature thunks
+     * for them yet
+     */
+    template <class Func, template <class, class...> class Conv>
+    using FunctionPointer = typename FunctionPointerImpl<Func, Conv>::type;
 }
 
 #endif /* LILAC_CORE_META_FUNCTION_HPP */
\ No newline at end of file
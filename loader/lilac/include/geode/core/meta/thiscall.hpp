@@ -1,6 +1,8 @@
 #ifndef LILAC_CORE_META_THISCALL_HPP
 #define LILAC_CORE_META_THISCALL_HPP
 
+#include <utility>
+
 namespace lilac::meta::x86 {
     template <class Ret, class... Args>
     class Thiscall {
@@ -11,9 +13,10 @@ namespace lilac::meta::x86 {
         }
 
     public:
+        using Pointer = Ret(__thiscall*)(Args...);
+
         static Ret invoke(void* address, Args... all) {
-            Ret(__thiscall * raw)(Args...) = reinterpret_cast<decltype(raw)>(address);
-            return raw(all...);
+            return reinterpret_cast<Pointer>(address)(std::forward<Args>(all)...);
         }
 
         template <Ret (*detour)(Args...)>
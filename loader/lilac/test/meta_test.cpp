@@ -1,20 +1,106 @@
+#include <geode/core/meta/defaultconv.hpp>
 #include <geode/core/meta/function.hpp>
-#include <geode/core/meta/hook.hpp>
-#include <geode/core/meta/membercall.hpp>
-#include <geode/core/meta/optcall.hpp>
-#include <geode/core/meta/thiscall.hpp>
+#include <chrono>
 #include <iostream>
 #include <string>
 
+#if defined(_WIN32)
+    #include <geode/core/meta/hook.hpp>
+    #include <geode/core/meta/membercall.hpp>
+    #include <geode/core/meta/optcall.hpp>
+    #include <geode/core/meta/thiscall.hpp>
+#endif
+
 using namespace lilac;
 using namespace lilac::meta;
 
-#if defined(GEODE_IS_WINDOWS)
+#if defined(_WIN32)
     #define NOINLINE __declspec(noinline)
-#elif defined(GEODE_IS_MACOS)
+#else
     #define NOINLINE __attribute__((noinline))
 #endif
 
+// Counts how often the argument is copied and moved on the way to the
+// function being called
+struct Counted {
+    static inline size_t copies = 0;
+    static inline size_t moves = 0;
+
+    int value;
+
+    Counted(int value) : value(value) {}
+
+    Counted(Counted const& other) : value(other.value) {
+        copies++;
+    }
+
+    Counted(Counted&& other) : value(other.value) {
+        moves++;
+    }
+};
+
+NOINLINE int bench_target(void* self, int a, float b, Counted c) {
+    return a + static_cast<int>(b) + c.value + (self != nullptr);
+}
+
+using BenchFunc = int(void*, int, float, Counted);
+
+// Time calls through each of the ways bindings can call a function at an
+// address. Codegen casts to FunctionPointer for conventions the compiler
+// supports, which should be as fast as calling the function pointer
+// directly, while Function is what the other conventions go through. lilac
+// only configures for the platforms of the game, elsewhere (like Linux) this
+// builds with: c++ -std=c++17 -O2 -I../include meta_test.cpp
+static bool call_overhead_bench() {
+    constexpr size_t calls = 50'000'000;
+    // volatile so the calls can't be turned into direct calls
+    void* volatile address = reinterpret_cast<void*>(&bench_target);
+    Counted arg(1);
+    bool ok = true;
+
+    auto time = [&](char const* name, auto&& call) {
+        Counted::copies = 0;
+        Counted::moves = 0;
+        call(arg);
+        auto copies = Counted::copies;
+        auto moves = Counted::moves;
+
+        int sum = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < calls; ++i) {
+            sum += call(arg);
+        }
+        auto elapsed = std::chrono::duration<double, std::nano>(
+            std::chrono::steady_clock::now() - start
+        );
+        std::cout << name << ": " << elapsed.count() / calls << " ns per call, " << copies
+                  << " copies and " << moves << " moves of the argument (" << sum << ")\n";
+        return copies;
+    };
+
+    auto raw = time("function pointer", [&](Counted const& c) {
+        return reinterpret_cast<BenchFunc*>(address)(nullptr, 1, 2.0f, c);
+    });
+    auto pointer = time("FunctionPointer", [&](Counted const& c) {
+        return reinterpret_cast<FunctionPointer<BenchFunc, DefaultConv>>(address)(
+            nullptr, 1, 2.0f, c
+        );
+    });
+    auto function = time("Function", [&](Counted const& c) {
+        return Function<BenchFunc, DefaultConv>(address)(nullptr, 1, 2.0f, c);
+    });
+
+    // the argument is copied once into the parameter, wrapping the call
+    // shouldn't add any more copies
+    if (pointer != raw || function != raw) {
+        std::cout << "FAIL: wrappers copy the argument\n";
+        ok = false;
+    }
+    return ok;
+}
+
+#if defined(_WIN32)
+
 int test1(int x) {
     std::cout << "Hi " << x << '\n';
     return 2;
@@ -73,7 +159,7 @@ struct get_wrapper<func, Conv> {
     static constexpr auto result = Conv<Ret, Args...>::template get_wrapper<func>();
 };
 
-int main() {
+static void conventions_test() {
     // Hook<&to_hook, &hook1, x86::Optcall> hook;
     Function<int(int, std::string, int, float, int, float, bool), x86::Optcall> f1 = test1;
 
@@ -129,4 +215,13 @@ int main() {
         69.0f, 2333.0f, 1333.0f, 1908.6f, 222.0f, 223.0f, 3, 45, 555, 666, 777.2f, "Goo", "Dbye"
     );
     std::cout << "membercall wrapper returned \"" << membercall_ret << "\"\n\n";
-}
\ No newline at end of file
+}
+
+#endif
+
+int main() {
+#if defined(_WIN32)
+    conventions_test();
+#endif
+    return call_overhead_bench() ? 0 : 1;
+}
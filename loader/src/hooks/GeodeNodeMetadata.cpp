@@ -3,6 +3,8 @@
 #include <Geode/modify/Field.hpp>
 #include <Geode/modify/CCNode.hpp>
 #include <cocos2d.h>
+#include <unordered_set>
+#include "../internal/SlabPool.hpp"
 
 USE_GEODE_NAMESPACE();
 using namespace geode::modifier;
@@ -14,22 +16,100 @@ constexpr auto METADATA_TAG = 0xB324ABC;
 
 struct ProxyCCNode;
 
+// IDs and attribute names are interned, so every node with the same ID
+// points to the same string and lookups can compare or hash the pointer
+// instead of the string. They are never freed, which is fine as long as
+// they aren't made up per node
+static std::unordered_set<std::string>& internedStrings() {
+    static std::unordered_set<std::string> strings;
+    return strings;
+}
+
+// the empty string is nullptr, like a node without an ID
+static std::string const* intern(std::string const& str) {
+    if (str.empty()) return nullptr;
+    return &*internedStrings().insert(str).first;
+}
+
+// nullptr if the string has never been interned
+static std::string const* findInterned(std::string const& str) {
+    auto it = internedStrings().find(str);
+    return it != internedStrings().end() ? &*it : nullptr;
+}
+
 class GeodeNodeMetadata final : public cocos2d::CCObject {
 private:
-    FieldContainer* m_fieldContainer;
+    FieldContainer m_fieldContainer;
     Ref<cocos2d::CCObject> m_userObject;
-    std::string m_id = "";
+    std::string const* m_id = nullptr;
     std::unique_ptr<Layout> m_layout = nullptr;
     PositionHint m_positionHint = PositionHint::Default;
-    std::unordered_map<std::string, std::any> m_attributes;
+    // by interned name. nodes have few attributes if any, so searching
+    // these is faster than hashing the name
+    std::vector<std::pair<std::string const*, std::any>> m_attributes;
+
+    // nodes by ID, built on the first lookup and rebuilt after it's
+    // invalidated. IDs that more than one node has map to nullptr, and are
+    // searched for without the index since which one is found depends on
+    // the order of the children. the nodes are retained, so that checking
+    // a hit never touches a node that was freed after being removed without
+    // going through the hooks
+    struct IDIndex {
+        std::unordered_map<std::string const*, Ref<CCNode>> m_nodes;
+        bool m_valid = false;
+        // what the count of children of the node was when this was built,
+        // in case they were changed without going through the hooks
+        unsigned int m_childCount = 0;
+
+        void add(CCNode* node) {
+            if (auto id = GeodeNodeMetadata::idOf(node)) {
+                auto [it, inserted] = m_nodes.try_emplace(id, node);
+                if (!inserted) {
+                    it->second = nullptr;
+                }
+            }
+        }
+
+        bool isCurrent(CCNode* target) const {
+            return m_valid && m_childCount == childCount(target);
+        }
+
+        // doesn't keep the removed nodes alive until the next lookup
+        void invalidate() {
+            if (m_valid) {
+                m_valid = false;
+                m_nodes.clear();
+            }
+        }
+    };
+    struct IDIndexes {
+        IDIndex m_children;
+        // every node in the subtree, for getChildByIDRecursive
+        IDIndex m_descendants;
+    };
+    // only allocated for the nodes that are searched, which most aren't
+    std::unique_ptr<IDIndexes> m_indexes;
 
     friend class ProxyCCNode;
     friend class cocos2d::CCNode;
 
-    GeodeNodeMetadata() : m_fieldContainer(new FieldContainer()) {}
+    GeodeNodeMetadata() = default;
+    virtual ~GeodeNodeMetadata() = default;
+
+    // there's metadata for every node with an ID or fields, which can be
+    // most of the objects in a level
+    static SlabPool& pool() {
+        // never destroyed, since nodes can outlive static destructors
+        static auto pool = new SlabPool(sizeof(GeodeNodeMetadata));
+        return *pool;
+    }
 
-    virtual ~GeodeNodeMetadata() {
-        delete m_fieldContainer;
+    static void* operator new(size_t) {
+        return pool().allocate();
+    }
+
+    static void operator delete(void* block) {
+        pool().deallocate(block);
     }
 
 public:
@@ -58,8 +138,110 @@ public:
         return meta;
     }
 
+    // doesn't create the metadata if the node has none
+    static GeodeNodeMetadata* get(CCNode* target) {
+        auto obj = target->m_pUserObject;
+        if (obj && obj->getTag() == METADATA_TAG) {
+            return static_cast<GeodeNodeMetadata*>(obj);
+        }
+        return nullptr;
+    }
+
+    static std::string const* idOf(CCNode* target) {
+        auto meta = get(target);
+        return meta ? meta->m_id : nullptr;
+    }
+
+    static unsigned int childCount(CCNode* target) {
+        return target->m_pChildren ? target->m_pChildren->count() : 0;
+    }
+
+    // the children of the node changed, or the ID of one of them did, which
+    // also changes the subtrees of all of its parents
+    static void invalidateChildren(CCNode* target) {
+        if (auto meta = get(target); meta && meta->m_indexes) {
+            meta->m_indexes->m_children.invalidate();
+        }
+        for (auto node = target; node; node = node->m_pParent) {
+            if (auto meta = get(node); meta && meta->m_indexes) {
+                meta->m_indexes->m_descendants.invalidate();
+            }
+        }
+    }
+
+    // the order getChildByIDRecursive searches in: all the children first,
+    // then the subtree of each one
+    static void collectDescendants(IDIndex& index, CCNode* node) {
+        for (auto child : CCArrayExt<CCNode>(node->m_pChildren)) {
+            index.add(child);
+        }
+        for (auto child : CCArrayExt<CCNode>(node->m_pChildren)) {
+            collectDescendants(index, child);
+        }
+    }
+
+    IDIndexes& indexes() {
+        if (!m_indexes) {
+            m_indexes = std::make_unique<IDIndexes>();
+        }
+        return *m_indexes;
+    }
+
+    IDIndex& children(CCNode* target) {
+        auto& index = this->indexes().m_children;
+        if (!index.isCurrent(target)) {
+            index.m_nodes.clear();
+            for (auto child : CCArrayExt<CCNode>(target->m_pChildren)) {
+                index.add(child);
+            }
+            index.m_childCount = childCount(target);
+            index.m_valid = true;
+        }
+        return index;
+    }
+
+    IDIndex& descendants(CCNode* target) {
+        auto& index = this->indexes().m_descendants;
+        if (!index.isCurrent(target)) {
+            index.m_nodes.clear();
+            collectDescendants(index, target);
+            index.m_childCount = childCount(target);
+            index.m_valid = true;
+        }
+        return index;
+    }
+
     FieldContainer* getFieldContainer() {
-        return m_fieldContainer;
+        return &m_fieldContainer;
+    }
+
+    // all metadata comes from the pool, so walking it finds every node with
+    // fields without keeping track of them as they're made
+    static size_t destroyFieldsOwnedBy(Mod* mod) {
+        // the destructors of fields can release nodes, and with them other
+        // metadata, so none are run while walking the pool, and the metadata
+        // is kept alive until its fields are gone
+        std::vector<Ref<GeodeNodeMetadata>> found;
+        pool().forEachLive([&](void* block) {
+            auto meta = static_cast<GeodeNodeMetadata*>(block);
+            if (meta->m_fieldContainer.hasFieldsOwnedBy(mod)) {
+                found.push_back(meta);
+            }
+        });
+        size_t count = 0;
+        for (auto& meta : found) {
+            count += meta->m_fieldContainer.destroyFieldsOwnedBy(mod);
+        }
+        return count;
+    }
+
+    std::any* getAttribute(std::string const* name) {
+        for (auto& [key, value] : m_attributes) {
+            if (key == name) {
+                return &value;
+            }
+        }
+        return nullptr;
     }
 };
 
@@ -77,6 +259,20 @@ struct ProxyCCNode : Modify<ProxyCCNode, CCNode> {
     virtual void setUserObject(CCObject* obj) {
         GeodeNodeMetadata::set(this)->m_userObject = obj;
     }
+
+    // the other overloads of these end up calling these ones
+    virtual void addChild(CCNode* child, int zOrder, int tag) {
+        CCNode::addChild(child, zOrder, tag);
+        GeodeNodeMetadata::invalidateChildren(this);
+    }
+    virtual void removeChild(CCNode* child, bool cleanup) {
+        CCNode::removeChild(child, cleanup);
+        GeodeNodeMetadata::invalidateChildren(this);
+    }
+    virtual void removeAllChildrenWithCleanup(bool cleanup) {
+        CCNode::removeAllChildrenWithCleanup(cleanup);
+        GeodeNodeMetadata::invalidateChildren(this);
+    }
 };
 
 static inline std::unordered_map<size_t, size_t> s_nextIndex;
@@ -84,40 +280,137 @@ size_t modifier::getFieldIndexForClass(size_t hash) {
 	return s_nextIndex[hash]++;
 }
 
+// fields that don't fit in their container come from pools of a few sizes,
+// and only the rare huge ones from the heap
+static SlabPool* fieldPool(size_t size) {
+    static auto pools = [] {
+        std::array<SlabPool*, 4> ret;
+        for (size_t i = 0; i < ret.size(); i++) {
+            ret[i] = new SlabPool(32 << i);
+        }
+        return ret;
+    }();
+    for (auto pool : pools) {
+        if (size <= pool->blockSize()) {
+            return pool;
+        }
+    }
+    return nullptr;
+}
+
+void* modifier::allocateField(size_t size) {
+    if (auto pool = fieldPool(size)) {
+        return pool->allocate();
+    }
+    return operator new(size);
+}
+
+void modifier::deallocateField(void* field, size_t size) {
+    if (auto pool = fieldPool(size)) {
+        pool->deallocate(field);
+    }
+    else {
+        operator delete(field);
+    }
+}
+
+size_t modifier::destroyFieldsOwnedBy(Mod* mod) {
+    return GeodeNodeMetadata::destroyFieldsOwnedBy(mod);
+}
+
 // not const because might modify contents
 FieldContainer* CCNode::getFieldContainer() {
     return GeodeNodeMetadata::set(this)->getFieldContainer();
 }
 
+// still returns a copy, since changing the signature would break every
+// mod built against it
 std::string CCNode::getID() {
-    return GeodeNodeMetadata::set(this)->m_id;
+    auto id = GeodeNodeMetadata::idOf(this);
+    return id ? *id : std::string();
 }
 
 void CCNode::setID(std::string const& id) {
-    GeodeNodeMetadata::set(this)->m_id = id;
+    auto meta = GeodeNodeMetadata::set(this);
+    auto atom = intern(id);
+    if (meta->m_id != atom) {
+        meta->m_id = atom;
+        if (m_pParent) {
+            GeodeNodeMetadata::invalidateChildren(m_pParent);
+        }
+    }
 }
 
-CCNode* CCNode::getChildByID(std::string const& id) {
-    for (auto child : CCArrayExt<CCNode>(m_pChildren)) {
-        if (child->getID() == id) {
+// searches without the indexes, for IDs more than one node has. a null ID
+// finds the first node without one
+static CCNode* scanChildren(CCNode* node, std::string const* id) {
+    for (auto child : CCArrayExt<CCNode>(node->getChildren())) {
+        if (GeodeNodeMetadata::idOf(child) == id) {
             return child;
         }
     }
     return nullptr;
 }
 
-CCNode* CCNode::getChildByIDRecursive(std::string const& id) {
-    if (auto child = this->getChildByID(id)) {
+static CCNode* scanDescendants(CCNode* node, std::string const* id) {
+    if (auto child = scanChildren(node, id)) {
         return child;
     }
-    for (auto child : CCArrayExt<CCNode>(m_pChildren)) {
-        if ((child = child->getChildByIDRecursive(id))) {
+    for (auto child : CCArrayExt<CCNode>(node->getChildren())) {
+        if ((child = scanDescendants(child, id))) {
             return child;
         }
     }
     return nullptr;
 }
 
+CCNode* CCNode::getChildByID(std::string const& id) {
+    if (id.empty()) {
+        return scanChildren(this, nullptr);
+    }
+    auto atom = findInterned(id);
+    if (!atom) return nullptr;
+
+    auto& index = GeodeNodeMetadata::set(this)->children(this);
+    auto it = index.m_nodes.find(atom);
+    if (it == index.m_nodes.end()) {
+        return nullptr;
+    }
+    if (CCNode* child = it->second) {
+        if (child->m_pParent == this && GeodeNodeMetadata::idOf(child) == atom) {
+            return child;
+        }
+        // the children were changed without going through the hooks
+        index.m_valid = false;
+    }
+    return scanChildren(this, atom);
+}
+
+CCNode* CCNode::getChildByIDRecursive(std::string const& id) {
+    if (id.empty()) {
+        return scanDescendants(this, nullptr);
+    }
+    auto atom = findInterned(id);
+    if (!atom) return nullptr;
+
+    auto& index = GeodeNodeMetadata::set(this)->descendants(this);
+    auto it = index.m_nodes.find(atom);
+    if (it == index.m_nodes.end()) {
+        return nullptr;
+    }
+    if (CCNode* node = it->second) {
+        auto parent = node->m_pParent;
+        while (parent && parent != this) {
+            parent = parent->m_pParent;
+        }
+        if (parent && GeodeNodeMetadata::idOf(node) == atom) {
+            return node;
+        }
+        index.m_valid = false;
+    }
+    return scanDescendants(this, atom);
+}
+
 void CCNode::setLayout(Layout* layout, bool apply) {
     GeodeNodeMetadata::set(this)->m_layout.reset(layout);
     if (apply) {
@@ -152,13 +445,25 @@ PositionHint CCNode::getPositionHint() {
 }
 
 void CCNode::setAttribute(std::string const& attr, std::any value) {
-    GeodeNodeMetadata::set(this)->m_attributes[attr] = value;
+    auto meta = GeodeNodeMetadata::set(this);
+    auto name = intern(attr);
+    if (auto old = meta->getAttribute(name)) {
+        *old = std::move(value);
+    }
+    else {
+        meta->m_attributes.emplace_back(name, std::move(value));
+    }
 }
 
 std::optional<std::any> CCNode::getAttributeInternal(std::string const& attr) {
-    auto meta = GeodeNodeMetadata::set(this);
-    if (meta->m_attributes.count(attr)) {
-        return meta->m_attributes.at(attr);
+    auto name = findInterned(attr);
+    if (!name && !attr.empty()) {
+        return std::nullopt;
+    }
+    if (auto meta = GeodeNodeMetadata::get(this)) {
+        if (auto value = meta->getAttribute(name)) {
+            return *value;
+        }
     }
     return std::nullopt;
 }
@@ -1,4 +1,5 @@
 #include <Geode/modify/IDManager.hpp>
+#include <InternalLoader.hpp>
 
 using namespace geode;
 
@@ -6,3 +7,26 @@ NodeIDs* NodeIDs::get() {
     static auto inst = new NodeIDs;
     return inst;
 }
+
+void NodeIDs::addProvider(std::string const& name, Provider<cocos2d::CCNode> fun, Mod* owner) {
+    // $register_ids runs during static initialization, before
+    // Mod::get() has been set for the mod
+    if (!owner) {
+        owner = InternalLoader::get()->getLoadingMod();
+    }
+    m_providers.insert({ name, { fun, owner } });
+}
+
+size_t NodeIDs::removeProvidersOwnedBy(Mod* mod) {
+    size_t removed = 0;
+    for (auto it = m_providers.begin(); it != m_providers.end();) {
+        if (it->second.m_owner == mod) {
+            it = m_providers.erase(it);
+            removed += 1;
+        }
+        else {
+            ++it;
+        }
+    }
+    return removed;
+}
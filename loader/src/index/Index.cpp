@@ -11,7 +11,10 @@
 #include <Geode/utils/map.hpp>
 #include <Geode/utils/ranges.hpp>
 #include <Geode/utils/string.hpp>
+#include <Geode/utils/trace.hpp>
 #include <fmt/format.h>
+#include <chrono>
+#include <fstream>
 #include <hash.hpp>
 #include <thread>
 
@@ -52,15 +55,14 @@ bool Index::isIndexUpdated() const {
     return m_upToDate;
 }
 
-std::vector<IndexItem> Index::getFeaturedItems() const {
-    std::vector<IndexItem> items;
+std::vector<IndexItem const*> Index::getFeaturedItems() const {
+    std::vector<IndexItem const*> items;
     items.reserve(m_featured.size());
-    std::transform(
-        m_featured.begin(), m_featured.end(), std::back_inserter(items),
-        [this](auto const& item) {
-            return this->getKnownItem(item);
+    for (auto& id : m_featured) {
+        if (m_itemIndices.count(id)) {
+            items.push_back(&m_items.at(m_itemIndices.at(id)));
         }
-    );
+    }
     return items;
 }
 
@@ -117,19 +119,20 @@ void Index::updateIndex(IndexUpdateCallback callback, bool force) {
         .join("index-update")
         .header(fmt::format("If-None-Match: \"{}\"", currentCommitSHA))
         .header("Accept: application/vnd.github.sha")
-        .fetch("https://api.github.com/repos/geode-sdk/mods/commits/main")
+        .fetch(m_source.m_commitURL)
         .text()
         .then([this, force, callback, currentCommitSHA](std::string const& upcomingCommitSHA) {
-            auto indexDir = Loader::get()->getGeodeSaveDirectory() / GEODE_INDEX_DIRECTORY;
-
             // gee i sure hope no one does 60 commits to the mod index an hour and download every
             // single one of them
-            if (upcomingCommitSHA == "") {
-                auto err = this->updateIndexFromLocalCache();
-                if (!err) {
-                    RETURN_ERROR(err.unwrapErr());
+            if (upcomingCommitSHA == "" || (!force && currentCommitSHA == upcomingCommitSHA)) {
+                if (!this->loadIndexSnapshot(currentCommitSHA)) {
+                    auto err = this->updateIndexFromLocalCache();
+                    if (!err) {
+                        RETURN_ERROR(err.unwrapErr());
+                    }
+                    this->saveIndexSnapshot(currentCommitSHA);
                 }
-                
+
                 m_upToDate = true;
                 m_updating = false;
 
@@ -137,66 +140,288 @@ void Index::updateIndex(IndexUpdateCallback callback, bool force) {
                 return;
             }
 
-            // update if forced or latest commit has
-            // different sha
-            if (force || currentCommitSHA != upcomingCommitSHA) {
-                // save new sha in file
-                (void)utils::file::writeString(indexDir / "current", upcomingCommitSHA);
-
-                web::AsyncWebRequest()
-                    .join("index-download")
-                    .fetch("https://github.com/geode-sdk/mods/zipball/main")
-                    .into(indexDir / "index.zip")
-                    .then([this, indexDir, callback](auto) {
-                        // delete old index
-                        try {
-                            if (ghc::filesystem::exists(indexDir / "index")) {
-                                ghc::filesystem::remove_all(indexDir / "index");
-                            }
-                        }
-                        catch (std::exception& e) {
-                            RETURN_ERROR("Unable to delete old index " + std::string(e.what()));
-                        }
-
-                        // unzip new index
-                        auto unzip = file::unzipTo(indexDir / "index.zip", indexDir);
-                        if (!unzip) {
-                            RETURN_ERROR(unzip.unwrapErr());
-                        }
-
-                        // update index
-                        auto err = this->updateIndexFromLocalCache();
-                        if (!err) {
-                            RETURN_ERROR(err.unwrapErr());
-                        }
-
-                        m_upToDate = true;
-                        m_updating = false;
-
-                        if (callback) callback(UpdateStatus::Finished, "", 100);
-                    })
-                    .expect([callback](std::string const& err) {
-                        RETURN_ERROR(err);
-                    })
-                    .progress([callback](web::SentAsyncWebRequest& req, double now, double total) {
-                        if (callback)
-                            callback(
-                                UpdateStatus::Progress, "Downloading",
-                                static_cast<int>(now / total * 100.0)
-                            );
-                    });
+            this->downloadIndexManifest(upcomingCommitSHA, callback);
+        })
+        .expect([callback](std::string const& err) {
+            RETURN_ERROR(err);
+        })
+        .progress([callback](web::SentAsyncWebRequest& req, double now, double total) {
+            if (callback)
+                callback(
+                    UpdateStatus::Progress, "Downloading", static_cast<int>(now / total * 100.0)
+                );
+        });
+}
+
+static bool isSafeIndexPath(std::string const& path) {
+    return path.size() && path.find("..") == std::string::npos &&
+        path.find('\\') == std::string::npos && path.front() != '/';
+}
+
+Result<IndexManifest> IndexManifest::parse(nlohmann::json const& json) {
+    try {
+        IndexManifest manifest;
+        manifest.m_settingsHash = json.value("geode.json", "");
+        for (auto& [folder, value] : json.at("entries").items()) {
+            Entry entry;
+            entry.m_hash = value.at("hash");
+            entry.m_files = value.at("files").get<std::vector<std::string>>();
+            // the manifest decides where files get written
+            if (!isSafeIndexPath(folder) || folder.find('/') != std::string::npos) {
+                return Err("Invalid entry name \"" + folder + "\"");
             }
-            else {
-                auto err = this->updateIndexFromLocalCache();
-                if (!err) {
-                    RETURN_ERROR(err.unwrapErr());
+            for (auto& file : entry.m_files) {
+                if (!isSafeIndexPath(file)) {
+                    return Err("Invalid file name \"" + file + "\" in " + folder);
                 }
+            }
+            manifest.m_entries.insert({ folder, std::move(entry) });
+        }
+        return Ok(manifest);
+    }
+    catch (std::exception& e) {
+        return Err("Invalid index manifest: " + std::string(e.what()));
+    }
+}
 
-                m_upToDate = true;
-                m_updating = false;
+void Index::downloadIndexManifest(std::string const& commit, IndexUpdateCallback callback) {
+    web::AsyncWebRequest()
+        .join("index-manifest")
+        .failOnError()
+        .fetch(fmt::format(fmt::runtime(m_source.m_fileURL), commit, "manifest.json"))
+        .json()
+        .then([this, commit, callback](nlohmann::json const& remote) {
+            auto indexDir = Loader::get()->getGeodeSaveDirectory() / GEODE_INDEX_DIRECTORY;
 
-                if (callback) callback(UpdateStatus::Finished, "", 100);
+            // nothing to compare against, so everything has to be downloaded
+            // anyway and one zip beats hundreds of small requests
+            auto localJson = readJSON(indexDir / "manifest.json");
+            if (!localJson || !ghc::filesystem::exists(indexDir / "index")) {
+                return this->downloadFullIndex(commit, std::make_optional(remote), callback);
+            }
+            auto local = IndexManifest::parse(localJson.unwrap());
+            if (!local) {
+                log::warn("Installed index manifest is invalid: {}", local.unwrapErr());
+                return this->downloadFullIndex(commit, std::make_optional(remote), callback);
             }
+            this->patchIndex(commit, local.unwrap(), remote, callback);
+        })
+        .expect([this, commit, callback](std::string const& err) {
+            log::info("Unable to get index manifest ({}), downloading full index", err);
+            this->downloadFullIndex(commit, std::nullopt, callback);
+        });
+}
+
+void Index::patchIndex(
+    std::string const& commit, IndexManifest const& local, nlohmann::json const& remoteJson,
+    IndexUpdateCallback callback
+) {
+    auto remoteRes = IndexManifest::parse(remoteJson);
+    if (!remoteRes) {
+        log::warn("{}, downloading full index", remoteRes.unwrapErr());
+        return this->downloadFullIndex(commit, std::nullopt, callback);
+    }
+    auto remote = remoteRes.unwrap();
+
+    auto indexDir = Loader::get()->getGeodeSaveDirectory() / GEODE_INDEX_DIRECTORY;
+    auto stagingDir = indexDir / "staging";
+
+    std::unordered_set<std::string> changed;
+    std::unordered_set<std::string> removed;
+    for (auto& [folder, entry] : remote.m_entries) {
+        auto old = local.m_entries.find(folder);
+        if (old == local.m_entries.end() || old->second.m_hash != entry.m_hash ||
+            !ghc::filesystem::exists(indexDir / "index" / folder)) {
+            changed.insert(folder);
+        }
+    }
+    for (auto& [folder, _] : local.m_entries) {
+        if (!remote.m_entries.count(folder)) {
+            removed.insert(folder);
+        }
+    }
+    auto settingsChanged = local.m_settingsHash != remote.m_settingsHash;
+
+    // past this point a single zip is cheaper than requesting every file
+    if (changed.size() * 2 > remote.m_entries.size()) {
+        return this->downloadFullIndex(commit, std::make_optional(remoteJson), callback);
+    }
+
+    // (path in the index, where to download it)
+    std::vector<std::pair<std::string, ghc::filesystem::path>> files;
+    try {
+        ghc::filesystem::remove_all(stagingDir);
+        ghc::filesystem::create_directories(stagingDir);
+        if (settingsChanged) {
+            files.push_back({ "geode.json", stagingDir / "geode.json" });
+        }
+        for (auto& folder : changed) {
+            for (auto& file : remote.m_entries.at(folder).m_files) {
+                auto target = stagingDir / folder / file;
+                ghc::filesystem::create_directories(target.parent_path());
+                files.push_back({ "index/" + folder + "/" + file, target });
+            }
+        }
+    }
+    catch (std::exception& e) {
+        RETURN_ERROR("Unable to prepare index update: " + std::string(e.what()));
+    }
+
+    log::info(
+        "Updating index: {} changed, {} removed, {} files to download", changed.size(),
+        removed.size(), files.size()
+    );
+
+    if (files.empty()) {
+        return this->applyIndexPatch(
+            commit, changed, removed, settingsChanged, remoteJson, callback
+        );
+    }
+
+    struct PatchState {
+        size_t m_total;
+        size_t m_remaining;
+        bool m_failed = false;
+    };
+
+    auto state = std::make_shared<PatchState>(PatchState { files.size(), files.size() });
+    for (auto& [path, target] : files) {
+        web::AsyncWebRequest()
+            .failOnError()
+            .fetch(fmt::format(fmt::runtime(m_source.m_fileURL), commit, path))
+            .into(target)
+            .then([=, this](auto) {
+                if (state->m_failed) return;
+                state->m_remaining -= 1;
+                if (callback) {
+                    callback(
+                        UpdateStatus::Progress, "Downloading",
+                        static_cast<uint8_t>(
+                            (state->m_total - state->m_remaining) * 100 / state->m_total
+                        )
+                    );
+                }
+                if (state->m_remaining == 0) {
+                    this->applyIndexPatch(
+                        commit, changed, removed, settingsChanged, remoteJson, callback
+                    );
+                }
+            })
+            .expect([=, this, path = path](std::string const& err) {
+                if (state->m_failed) return;
+                state->m_failed = true;
+                log::warn("Unable to download {} ({}), downloading full index", path, err);
+                this->downloadFullIndex(commit, std::make_optional(remoteJson), callback);
+            });
+    }
+}
+
+void Index::applyIndexPatch(
+    std::string const& commit, std::unordered_set<std::string> const& changed,
+    std::unordered_set<std::string> const& removed, bool settingsChanged,
+    nlohmann::json const& manifest, IndexUpdateCallback callback
+) {
+    auto indexDir = Loader::get()->getGeodeSaveDirectory() / GEODE_INDEX_DIRECTORY;
+    auto modsDir = indexDir / "index";
+    auto stagingDir = indexDir / "staging";
+
+    try {
+        for (auto& folder : removed) {
+            ghc::filesystem::remove_all(modsDir / folder);
+        }
+        for (auto& folder : changed) {
+            ghc::filesystem::remove_all(modsDir / folder);
+            ghc::filesystem::rename(stagingDir / folder, modsDir / folder);
+        }
+        if (settingsChanged) {
+            ghc::filesystem::remove(indexDir / "geode.json");
+            ghc::filesystem::rename(stagingDir / "geode.json", indexDir / "geode.json");
+        }
+        ghc::filesystem::remove_all(stagingDir);
+    }
+    catch (std::exception& e) {
+        // the installed index is now partially updated, so it has to be
+        // replaced as a whole
+        log::warn("Unable to apply index update ({}), downloading full index", e.what());
+        return this->downloadFullIndex(commit, std::make_optional(manifest), callback);
+    }
+
+    (void)utils::file::writeString(indexDir / "manifest.json", manifest.dump());
+    (void)utils::file::writeString(indexDir / "current", commit);
+
+    // only reparse what changed if the rest is already loaded
+    if (m_items.empty()) {
+        auto err = this->updateIndexFromLocalCache();
+        if (!err) {
+            RETURN_ERROR(err.unwrapErr());
+        }
+    }
+    else {
+        if (settingsChanged) {
+            this->loadIndexSettings();
+        }
+        auto folders = changed;
+        folders.insert(removed.begin(), removed.end());
+        this->updateIndexItems(folders);
+    }
+    this->saveIndexSnapshot(commit);
+
+    m_upToDate = true;
+    m_updating = false;
+
+    if (callback) callback(UpdateStatus::Finished, "", 100);
+}
+
+void Index::downloadFullIndex(
+    std::string const& commit, std::optional<nlohmann::json> const& manifest,
+    IndexUpdateCallback callback
+) {
+    auto indexDir = Loader::get()->getGeodeSaveDirectory() / GEODE_INDEX_DIRECTORY;
+
+    web::AsyncWebRequest()
+        .join("index-download")
+        .failOnError()
+        .fetch(m_source.m_snapshotURL)
+        .into(indexDir / "index.zip")
+        .then([this, indexDir, commit, manifest, callback](auto) {
+            // delete old index
+            try {
+                if (ghc::filesystem::exists(indexDir / "index")) {
+                    ghc::filesystem::remove_all(indexDir / "index");
+                }
+            }
+            catch (std::exception& e) {
+                RETURN_ERROR("Unable to delete old index " + std::string(e.what()));
+            }
+
+            // unzip new index
+            auto unzip = file::unzipTo(indexDir / "index.zip", indexDir);
+            if (!unzip) {
+                RETURN_ERROR(unzip.unwrapErr());
+            }
+
+            // update index
+            auto err = this->updateIndexFromLocalCache();
+            if (!err) {
+                RETURN_ERROR(err.unwrapErr());
+            }
+
+            // save new sha & manifest only once the index is in place, so a
+            // failed download gets retried
+            (void)utils::file::writeString(indexDir / "current", commit);
+            if (manifest) {
+                (void)utils::file::writeString(indexDir / "manifest.json", manifest.value().dump());
+            }
+            else {
+                std::error_code ec;
+                ghc::filesystem::remove(indexDir / "manifest.json", ec);
+            }
+            this->saveIndexSnapshot(commit);
+
+            m_upToDate = true;
+            m_updating = false;
+
+            if (callback) callback(UpdateStatus::Finished, "", 100);
         })
         .expect([callback](std::string const& err) {
             RETURN_ERROR(err);
@@ -209,6 +434,14 @@ void Index::updateIndex(IndexUpdateCallback callback, bool force) {
         });
 }
 
+IndexSource Index::getSource() const {
+    return m_source;
+}
+
+void Index::setSource(IndexSource const& source) {
+    m_source = source;
+}
+
 void Index::addIndexItemFromFolder(ghc::filesystem::path const& dir) {
     if (ghc::filesystem::exists(dir / "index.json")) {
         auto readJson = readJSON(dir / "index.json");
@@ -230,17 +463,14 @@ void Index::addIndexItemFromFolder(ghc::filesystem::path const& dir) {
         auto info = infoRes.unwrap();
 
         // make sure only latest version is present in index
-        auto old = std::find_if(m_items.begin(), m_items.end(), [info](IndexItem const& item) {
-            return item.m_info.m_id == info.m_id;
-        });
-        if (old != m_items.end()) {
-            // this one is newer
-            if (old->m_info.m_version < info.m_version) {
-                m_items.erase(old);
-            } else {
+        std::optional<size_t> old;
+        if (m_itemIndices.count(info.m_id)) {
+            old = m_itemIndices.at(info.m_id);
+            // this one is older
+            if (!(m_items.at(*old).m_info.m_version < info.m_version)) {
                 log::warn(
                     "Found older version of ({} < {}) of {}, skipping",
-                    info.m_version, old->m_info.m_version, info.m_id
+                    info.m_version, m_items.at(*old).m_info.m_version, info.m_id
                 );
                 return;
             }
@@ -283,7 +513,6 @@ void Index::addIndexItemFromFolder(ghc::filesystem::path const& dir) {
                     return;
                 }
                 item.m_categories = json["categories"].template get<std::unordered_set<std::string>>();
-                m_categories.insert(item.m_categories.begin(), item.m_categories.end());
             }
         }
         catch (std::exception& e) {
@@ -291,23 +520,38 @@ void Index::addIndexItemFromFolder(ghc::filesystem::path const& dir) {
             return;
         }
 
-        m_items.push_back(item);
+        if (old) {
+            m_items.at(*old) = std::move(item);
+        }
+        else {
+            m_itemIndices.insert({ item.m_info.m_id, m_items.size() });
+            m_items.push_back(std::move(item));
+        }
     }
     else {
         log::warn("Index directory {} is missing index.json, skipping", dir);
     }
 }
 
-Result<> Index::updateIndexFromLocalCache() {
-    m_items.clear();
+void Index::loadIndexSettings() {
     auto baseIndexDir = Loader::get()->getGeodeSaveDirectory() / GEODE_INDEX_DIRECTORY;
-
-    // load geode.json (index settings)
     if (auto baseIndexJson = readJSON(baseIndexDir / "geode.json")) {
         auto json = baseIndexJson.unwrap();
         auto checker = JsonChecker(json);
         checker.root("[index/geode.json]").obj().has("featured").into(m_featured);
     }
+}
+
+Result<> Index::updateIndexFromLocalCache() {
+    GEODE_TRACE_ZONE("index::parse");
+    auto start = std::chrono::steady_clock::now();
+
+    m_items.clear();
+    m_itemIndices.clear();
+    auto baseIndexDir = Loader::get()->getGeodeSaveDirectory() / GEODE_INDEX_DIRECTORY;
+
+    // load geode.json (index settings)
+    this->loadIndexSettings();
 
     // load index mods
     auto modsDir = baseIndexDir / "index";
@@ -317,7 +561,13 @@ Result<> Index::updateIndexFromLocalCache() {
                 this->addIndexItemFromFolder(dir);
             }
         }
-        log::info("Index updated");
+        this->rebuildItemLookups();
+        log::info(
+            "Index updated ({} entries parsed in {}ms)", m_items.size(),
+            std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now() - start
+            ).count()
+        );
         return Ok();
     }
     else {
@@ -328,28 +578,102 @@ Result<> Index::updateIndexFromLocalCache() {
     }
 }
 
-std::vector<IndexItem> Index::getItems() const {
+void Index::updateIndexItems(std::unordered_set<std::string> const& folders) {
+    auto modsDir = Loader::get()->getGeodeSaveDirectory() / GEODE_INDEX_DIRECTORY / "index";
+    m_items.erase(
+        std::remove_if(
+            m_items.begin(), m_items.end(),
+            [&](IndexItem const& item) {
+                return folders.count(item.m_path.filename().string());
+            }
+        ),
+        m_items.end()
+    );
+    // adding items only needs the ID lookup to find replaced ones, the
+    // rest (and the search index) is rebuilt once everything is added
+    m_itemIndices.clear();
+    for (size_t i = 0; i < m_items.size(); i++) {
+        m_itemIndices.insert({ m_items[i].m_info.m_id, i });
+    }
+    for (auto& folder : folders) {
+        if (ghc::filesystem::is_directory(modsDir / folder)) {
+            this->addIndexItemFromFolder(modsDir / folder);
+        }
+    }
+    this->rebuildItemLookups();
+    log::info("Index updated ({} entries reparsed)", folders.size());
+}
+
+void Index::rebuildItemLookups() {
+    m_itemIndices.clear();
+    m_categoryItems.clear();
+    m_platformItems.clear();
+    m_categories.clear();
+    m_search.clear();
+    m_search.reserve(m_items.size());
+    for (size_t i = 0; i < m_items.size(); i++) {
+        auto& item = m_items[i];
+        m_itemIndices.insert({ item.m_info.m_id, i });
+        m_search.add(item.m_info);
+        for (auto& category : item.m_categories) {
+            m_categoryItems[category].push_back(i);
+            m_categories.insert(category);
+        }
+        for (auto& platform : item.m_download.m_platforms) {
+            m_platformItems[platform].push_back(i);
+        }
+    }
+    m_search.finish();
+}
+
+std::vector<IndexItem const*> Index::searchItems(
+    std::string const& query, SearchIndex::Fields fields
+) const {
+    std::vector<IndexItem const*> items;
+    for (auto& match : m_search.search(query, fields)) {
+        items.push_back(&m_items[match.m_document]);
+    }
+    return items;
+}
+
+std::span<IndexItem const> Index::getItems() const {
     return m_items;
 }
 
-std::unordered_set<std::string> Index::getCategories() const {
+std::unordered_set<std::string> const& Index::getCategories() const {
     return m_categories;
 }
 
-bool Index::isKnownItem(std::string const& id) const {
-    for (auto& item : m_items) {
-        if (item.m_info.m_id == id) return true;
+std::vector<IndexItem const*> Index::getItemsInCategory(std::string const& category) const {
+    std::vector<IndexItem const*> items;
+    if (m_categoryItems.count(category)) {
+        for (auto& index : m_categoryItems.at(category)) {
+            items.push_back(&m_items[index]);
+        }
     }
-    return false;
+    return items;
 }
 
-IndexItem Index::getKnownItem(std::string const& id) const {
-    for (auto& item : m_items) {
-        if (item.m_info.m_id == id) {
-            return item;
+std::vector<IndexItem const*> Index::getItemsForPlatform(PlatformID platform) const {
+    std::vector<IndexItem const*> items;
+    if (m_platformItems.count(platform)) {
+        for (auto& index : m_platformItems.at(platform)) {
+            items.push_back(&m_items[index]);
         }
     }
-    return IndexItem();
+    return items;
+}
+
+bool Index::isKnownItem(std::string const& id) const {
+    return m_itemIndices.count(id);
+}
+
+IndexItem const& Index::getKnownItem(std::string const& id) const {
+    static IndexItem const empty;
+    if (m_itemIndices.count(id)) {
+        return m_items.at(m_itemIndices.at(id));
+    }
+    return empty;
 }
 
 struct UninstalledDependency {
@@ -471,7 +795,7 @@ bool Index::isUpdateAvailableForItem(IndexItem const& item) const {
 
 bool Index::areUpdatesAvailable() const {
     for (auto& item : m_items) {
-        if (this->isUpdateAvailableForItem(item.m_info.m_id)) {
+        if (this->isUpdateAvailableForItem(item)) {
             return true;
         }
     }
@@ -481,9 +805,9 @@ bool Index::areUpdatesAvailable() const {
 Result<InstallHandle> Index::installAllUpdates() {
     // find items that need updating
     std::vector<IndexItem> itemsToUpdate {};
-    for (auto& item : m_items) {
-        if (this->isUpdateAvailableForItem(item)) {
-            itemsToUpdate.push_back(item);
+    for (auto& item : this->getItemsForPlatform(GEODE_PLATFORM_TARGET)) {
+        if (this->isUpdateAvailableForItem(*item)) {
+            itemsToUpdate.push_back(*item);
         }
     }
     return this->installItems(itemsToUpdate);
@@ -541,46 +865,126 @@ void InstallItems::error(std::string const& info) {
 }
 
 void InstallItems::finish(bool replaceFiles) {
-    // move files from temp dir to geode directory
+    std::vector<ghc::filesystem::path> files;
+    for (auto& [_, download] : m_downloads) {
+        files.push_back(download.m_file);
+    }
     auto tempDir = Loader::get()->getGeodeSaveDirectory() / GEODE_INDEX_DIRECTORY / "temp";
-    for (auto& file : ghc::filesystem::directory_iterator(tempDir)) {
-        try {
-            auto modDir = Loader::get()->getGeodeDirectory() / "mods";
-            auto targetFile = modDir / file.path().filename();
-            auto targetName = file.path().stem();
-
-            if (!replaceFiles) {
-                // find valid filename that doesn't exist yet
-                auto filename = ghc::filesystem::path(targetName).replace_extension("").string();
-
-                size_t number = 0;
-                while (ghc::filesystem::exists(targetFile)) {
-                    targetFile = modDir / (filename + std::to_string(number) + ".geode");
-                    number++;
+    auto modDir = Loader::get()->getGeodeDirectory() / "mods";
+
+    // moving the files and opening every archive takes a while when
+    // installing many mods, so do it on a worker to not freeze the game
+    std::thread([self = shared_from_this(), files, tempDir, modDir, replaceFiles]() {
+        GEODE_TRACE_ZONE("index::finish-install");
+
+        // a file being moved, and where the mod it replaced was put aside
+        struct Move {
+            ghc::filesystem::path m_from;
+            ghc::filesystem::path m_to;
+            std::optional<ghc::filesystem::path> m_backup;
+        };
+        std::vector<Move> moves;
+
+        // put everything back if any move fails, so that either all of the
+        // mods are installed or none are. returns the files that couldn't
+        // be put back
+        auto rollback = [&]() {
+            std::vector<std::string> stuck;
+            for (auto it = moves.rbegin(); it != moves.rend(); it++) {
+                std::error_code ec;
+                if (ghc::filesystem::exists(it->m_to, ec) && !ghc::filesystem::exists(it->m_from, ec)) {
+                    ghc::filesystem::rename(it->m_to, it->m_from, ec);
+                }
+                if (!ec && it->m_backup) {
+                    ghc::filesystem::rename(it->m_backup.value(), it->m_to, ec);
+                }
+                if (ec) {
+                    stuck.push_back(it->m_to.filename().string());
                 }
             }
+            return stuck;
+        };
 
-            // move file
-            ghc::filesystem::rename(file, targetFile);
-        }
-        catch (std::exception& e) {
+        // move files from temp dir to geode directory
+        std::vector<std::pair<ghc::filesystem::path, Result<ModInfo>>> installed;
+        for (auto& file : files) {
+            auto targetFile = modDir / file.filename();
             try {
-                ghc::filesystem::remove_all(tempDir);
+                auto targetName = file.stem();
+
+                if (!replaceFiles) {
+                    // find valid filename that doesn't exist yet
+                    auto filename =
+                        ghc::filesystem::path(targetName).replace_extension("").string();
+
+                    size_t number = 0;
+                    while (ghc::filesystem::exists(targetFile)) {
+                        targetFile = modDir / (filename + std::to_string(number) + ".geode");
+                        number++;
+                    }
+                }
+
+                auto& move = moves.emplace_back(Move { file, targetFile, std::nullopt });
+                // keep the mod being replaced until every file is in place
+                if (ghc::filesystem::exists(targetFile)) {
+                    auto backup = tempDir / (targetFile.filename().string() + ".old");
+                    ghc::filesystem::rename(targetFile, backup);
+                    move.m_backup = backup;
+                }
+
+                // move file
+                ghc::filesystem::rename(file, targetFile);
             }
-            catch (...) {
+            catch (std::exception& e) {
+                auto stuck = rollback();
+                try {
+                    ghc::filesystem::remove_all(tempDir);
+                }
+                catch (...) {
+                }
+                auto error = "Unable to move downloaded file to mods directory: \"" +
+                    std::string(e.what()) +
+                    " \" "
+                    "(This might be due to insufficient permissions to "
+                    "write files under SteamLibrary, try running GD as "
+                    "administrator)";
+                if (stuck.empty()) {
+                    error += ". No mods were installed";
+                }
+                else {
+                    error += ". These files couldn't be restored and may be "
+                        "incomplete: " + ranges::join(stuck, std::string(", "));
+                }
+                return Loader::get()->queueInGDThread([self, error]() {
+                    self->fail(error);
+                });
             }
-            return this->error(
-                "Unable to move downloaded file to mods directory: \"" + std::string(e.what()) +
-                " \" "
-                "(This might be due to insufficient permissions to "
-                "write files under SteamLibrary, try running GD as "
-                "administrator)"
-            );
+
         }
-    }
 
-    // load mods
-    (void)Loader::get()->refreshModsList();
+        // every file is in place, so the replaced mods can go
+        for (auto& move : moves) {
+            if (move.m_backup) {
+                std::error_code ec;
+                ghc::filesystem::remove(move.m_backup.value(), ec);
+            }
+            // read the mod while still off the GD thread, so loading it
+            // only has to add it to the loader
+            installed.push_back({ move.m_to, ModInfo::createFromGeodeFile(move.m_to) });
+        }
+
+        Loader::get()->queueInGDThread([self, installed]() {
+            self->installed(installed);
+        });
+    }).detach();
+}
+
+void InstallItems::installed(
+    std::vector<std::pair<ghc::filesystem::path, Result<ModInfo>>> const& files
+) {
+    // load only the new mods rather than rescanning every mod
+    auto loaded = Loader::get()->loadInstalledMods(files);
+    m_finished = true;
 
     // finished
     this->post(UpdateStatus::Finished, "", 100);
@@ -592,111 +996,237 @@ void InstallItems::finish(bool replaceFiles) {
 
     // if no one is listening, show a popup anyway
     if (!m_callbacks.size()) {
-        FLAlertLayer::create(
-            "Mods installed",
-            "The following <cy>mods</c> have been installed: " +
-                ranges::join(m_toInstall, std::string(",")) +
-                "\n"
-                "Please <cr>restart the game</c> to apply",
-            "OK"
-        )
-            ->show();
+        // reinstalled mods and ones that failed to load still need a restart
+        std::vector<std::string> needRestart;
+        for (auto& id : m_toInstall) {
+            auto wasLoaded = std::find_if(loaded.begin(), loaded.end(), [&](Mod* mod) {
+                return mod->getID() == id;
+            });
+            if (wasLoaded == loaded.end()) {
+                needRestart.push_back(id);
+            }
+        }
+        auto message = "The following <cy>mods</c> have been installed: " +
+            ranges::join(m_toInstall, std::string(","));
+        if (needRestart.size()) {
+            message += "\nPlease <cr>restart the game</c> to apply changes to: " +
+                ranges::join(needRestart, std::string(","));
+        }
+        FLAlertLayer::create("Mods installed", message, "OK")->show();
     }
 
     // no longer need to ensure aliveness
     Index::get()->m_installations.erase(shared_from_this());
 }
 
+// mods downloaded at once when installing several, the rest wait in line
+static constexpr size_t MAX_PARALLEL_DOWNLOADS = 3;
+
+namespace {
+    // written to from the networking thread as the body arrives
+    struct DownloadStream {
+        std::ofstream m_file;
+        digest::SHA3_256 m_hasher;
+        // set when writing the file failed, which cancels the request
+        bool m_writeFailed = false;
+    };
+}
+
 InstallItems::CallbackID InstallItems::start(ItemInstallCallback callback, bool replaceFiles) {
     auto id = this->join(callback);
 
     // check if started already, if so, behave like join
     if (m_started) return id;
     m_started = true;
+    m_replaceFiles = replaceFiles;
+
+    auto tempDir = Loader::get()->getGeodeSaveDirectory() / GEODE_INDEX_DIRECTORY / "temp";
+    (void)file::createDirectoryAll(tempDir);
 
     for (auto& inst : m_toInstall) {
         // by virtue of running this function we know item must be valid
-        auto item = Index::get()->getKnownItem(inst);
-
-        auto indexDir = Loader::get()->getGeodeSaveDirectory() / GEODE_INDEX_DIRECTORY;
-        (void)file::createDirectoryAll(indexDir / "temp");
-        auto tempFile = indexDir / "temp" / item.m_download.m_filename;
-
-        m_downloaded.push_back(tempFile);
-
-        auto handle =
-            web::AsyncWebRequest()
-                .join("install_mod_" + inst)
-                .fetch(item.m_download.m_url)
-                .into(tempFile)
-                .then([this, replaceFiles, item, inst, indexDir, tempFile](auto) {
-                    // check for 404
-                    auto notFound = utils::file::readString(tempFile);
-                    if (notFound && notFound.unwrap() == "Not Found") {
-                        try {
-                            ghc::filesystem::remove(tempFile);
-                        }
-                        catch (...) {
-                        }
-                        return this->error(
-                            "Binary file download returned \"Not found\". Report "
-                            "this to the Geode development team."
-                        );
-                    }
-
-                    // verify checksum
-                    this->progress("Verifying", 100);
-                    if (::calculateHash(tempFile) != item.m_download.m_hash) {
-                        try {
-                            ghc::filesystem::remove(tempFile);
-                        }
-                        catch (...) {
-                        }
-                        return this->error(
-                            "Checksum mismatch! (Downloaded file did not match what "
-                            "was expected. Try again, and if the download fails another time, "
-                            "report this to the Geode development team."
-                        );
-                    }
+        auto& item = Index::get()->getKnownItem(inst);
 
-                    // finished() just checks if the web requests are done
-                    if (this->finished()) {
-                        this->finish(replaceFiles);
-                    }
-                })
-                .expect([this, inst](std::string const& error) {
-                    this->error(error);
-                    this->cancel();
-                })
-                .cancelled([this, item](auto&) {
-                    this->cancel();
-                })
-                .progress([this, inst](web::SentAsyncWebRequest&, double now, double total) {
-                    this->progress("Downloading binary", static_cast<uint8_t>(now / total * 100.0));
-                })
-                .send();
-
-        m_handles.push_back(handle);
+        Download download;
+        download.m_file = tempDir / item.m_download.m_filename;
+        download.m_partFile = tempDir / (item.m_download.m_filename + ".part");
+        m_downloads.insert({ inst, download });
+        m_queued.push_back(inst);
     }
     // manage installation in the index until it's finished so
     // even if no one listens to it it doesn't get freed from
     // memory
     Index::get()->m_installations.insert(shared_from_this());
 
+    this->startQueued();
+
     return id;
 }
 
+void InstallItems::startQueued() {
+    while (!m_failed && m_queued.size() && m_handles.size() < MAX_PARALLEL_DOWNLOADS) {
+        auto id = m_queued.front();
+        m_queued.pop_front();
+        this->download(id);
+    }
+}
+
+void InstallItems::download(std::string const& id) {
+    auto& item = Index::get()->getKnownItem(id);
+    auto& download = m_downloads.at(id);
+
+    // continue from where an interrupted download left off. if the part is
+    // of some other version of the mod, the checksum catches it
+    auto stream = std::make_shared<DownloadStream>();
+    size_t offset = 0;
+    if (ghc::filesystem::exists(download.m_partFile)) {
+        std::ifstream part(download.m_partFile, std::ios::binary);
+        std::vector<char> buffer(HASH_READ_CHUNK);
+        while (part.read(buffer.data(), buffer.size()) || part.gcount()) {
+            stream->m_hasher.update(buffer.data(), static_cast<size_t>(part.gcount()));
+        }
+        std::error_code ec;
+        offset = static_cast<size_t>(ghc::filesystem::file_size(download.m_partFile, ec));
+    }
+    stream->m_file.open(download.m_partFile, std::ios::out | std::ios::binary | std::ios::app);
+    if (!stream->m_file.is_open()) {
+        return this->fail("Unable to open " + download.m_partFile.string());
+    }
+
+    auto handle =
+        web::AsyncWebRequest()
+            .resumeFrom(offset)
+            .failOnError()
+            .fetch(item.m_download.m_url)
+            .stream([stream](uint8_t const* data, size_t size) {
+                // hash while downloading so verifying doesn't have to read
+                // the file back
+                stream->m_file.write(reinterpret_cast<char const*>(data), size);
+                stream->m_hasher.update(data, size);
+                stream->m_writeFailed = !stream->m_file.good();
+                return !stream->m_writeFailed;
+            })
+            .then([self = shared_from_this(), id, offset, stream](auto) {
+                stream->m_file.close();
+                auto hash = stream->m_hasher.finishHex();
+                self->m_handles.erase(id);
+                if (self->m_failed) return;
+
+                auto& download = self->m_downloads.at(id);
+                auto& item = Index::get()->getKnownItem(id);
+
+                // verify checksum
+                if (hash != item.m_download.m_hash) {
+                    std::error_code ec;
+                    ghc::filesystem::remove(download.m_partFile, ec);
+                    if (offset && !download.m_restarted) {
+                        download.m_restarted = true;
+                        return self->download(id);
+                    }
+                    return self->fail(
+                        "Checksum mismatch! (Downloaded file did not match what "
+                        "was expected. Try again, and if the download fails another time, "
+                        "report this to the Geode development team."
+                    );
+                }
+
+                try {
+                    ghc::filesystem::remove(download.m_file);
+                    ghc::filesystem::rename(download.m_partFile, download.m_file);
+                }
+                catch (std::exception& e) {
+                    return self->fail("Unable to save downloaded file: " + std::string(e.what()));
+                }
+                download.m_done = true;
+                self->downloaded(id);
+            })
+            .cancelled([self = shared_from_this(), id, stream](web::SentAsyncWebRequest&) {
+                // a failed write cancels the request, which would otherwise
+                // only be reported as cancelled
+                self->m_handles.erase(id);
+                if (stream->m_writeFailed) {
+                    self->fail(
+                        "Unable to write " + self->m_downloads.at(id).m_partFile.string() +
+                        " (the disk may be full, or the file not writable)"
+                    );
+                }
+            })
+            .expect([self = shared_from_this(), id, offset](std::string const& error) {
+                self->m_handles.erase(id);
+                if (self->m_failed) return;
+
+                // the server may not support ranges, or the part may be
+                // longer than the file now is, so try once more from scratch
+                auto& download = self->m_downloads.at(id);
+                if (offset && !download.m_restarted) {
+                    download.m_restarted = true;
+                    std::error_code ec;
+                    ghc::filesystem::remove(download.m_partFile, ec);
+                    return self->download(id);
+                }
+                self->fail(error);
+            })
+            .progress([self = shared_from_this(), id,
+                       offset](web::SentAsyncWebRequest&, double now, double total) {
+                // curl only counts what's left when resuming
+                if (total > 0) {
+                    self->downloadProgress(
+                        id, static_cast<uint8_t>((offset + now) / (offset + total) * 100.0)
+                    );
+                }
+            })
+            .send();
+
+    m_handles.insert({ id, handle });
+}
+
+void InstallItems::downloadProgress(std::string const& id, uint8_t progress) {
+    m_downloads.at(id).m_progress = progress;
+
+    size_t total = 0;
+    for (auto& [_, download] : m_downloads) {
+        total += download.m_done ? 100 : download.m_progress;
+    }
+    this->progress("Downloading binary", static_cast<uint8_t>(total / m_downloads.size()));
+}
+
+void InstallItems::downloaded(std::string const& id) {
+    this->downloadProgress(id, 100);
+    if (this->downloadsDone()) {
+        this->finish(m_replaceFiles);
+    }
+    else {
+        this->startQueued();
+    }
+}
+
 bool InstallItems::finished() const {
-    for (auto& inst : m_handles) {
-        if (!inst->finished()) {
+    return m_finished;
+}
+
+bool InstallItems::downloadsDone() const {
+    for (auto& [_, download] : m_downloads) {
+        if (!download.m_done) {
             return false;
         }
     }
     return true;
 }
 
-void InstallItems::cancel() {
-    for (auto& inst : m_handles) {
-        inst->cancel();
+void InstallItems::fail(std::string const& info) {
+    if (m_failed) return;
+    m_failed = true;
+    m_queued.clear();
+    // partially downloaded files are kept so the next attempt can resume
+    // them
+    auto handles = m_handles;
+    for (auto& [_, handle] : handles) {
+        handle->cancel();
     }
+    this->error(info);
+    Index::get()->m_installations.erase(shared_from_this());
+}
+
+void InstallItems::cancel() {
+    this->fail("Request cancelled");
 }
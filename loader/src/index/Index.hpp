@@ -1,8 +1,12 @@
 #pragma once
 
+#include "SearchIndex.hpp"
+
 #include <Geode/utils/web.hpp>
+#include <deque>
 #include <mutex>
 #include <optional>
+#include <span>
 #include <unordered_set>
 
 USE_GEODE_NAMESPACE();
@@ -25,6 +29,43 @@ using ItemInstallCallback =
     std::function<void(InstallHandle, UpdateStatus, std::string const&, uint8_t)>;
 using IndexUpdateCallback = std::function<void(UpdateStatus, std::string const&, uint8_t)>;
 
+/**
+ * Where the index is downloaded from. Can be pointed at a local server for
+ * testing
+ */
+struct IndexSource {
+    /**
+     * Returns the SHA of the latest commit of the index
+     */
+    std::string m_commitURL = "https://api.github.com/repos/geode-sdk/mods/commits/main";
+    /**
+     * Full snapshot of the index as a zip
+     */
+    std::string m_snapshotURL = "https://github.com/geode-sdk/mods/zipball/main";
+    /**
+     * A single file of the index at some commit, with {0} replaced by the
+     * commit and {1} by the path of the file
+     */
+    std::string m_fileURL = "https://raw.githubusercontent.com/geode-sdk/mods/{0}/{1}";
+};
+
+/**
+ * Hashes of every entry in the index, published as manifest.json next to
+ * it. Comparing the manifest of the installed index against the latest one
+ * tells which entries need to be downloaded again
+ */
+struct IndexManifest {
+    struct Entry {
+        std::string m_hash;
+        std::vector<std::string> m_files;
+    };
+
+    std::string m_settingsHash;
+    std::unordered_map<std::string, Entry> m_entries;
+
+    static Result<IndexManifest> parse(nlohmann::json const& json);
+};
+
 struct IndexItem {
     struct Download {
         std::string m_url;
@@ -44,16 +85,40 @@ public:
     using CallbackID = size_t;
 
 private:
+    struct Download {
+        // where the file is downloaded to, and where it's moved once its
+        // checksum has been verified
+        ghc::filesystem::path m_partFile;
+        ghc::filesystem::path m_file;
+        uint8_t m_progress = 0;
+        bool m_done = false;
+        // whether the download has already been restarted from scratch
+        bool m_restarted = false;
+    };
+
     bool m_started = false;
+    bool m_failed = false;
+    // set once the mods have been moved in place and loaded
+    bool m_finished = false;
+    bool m_replaceFiles = true;
     std::unordered_set<std::string> m_toInstall;
-    std::vector<web::SentAsyncWebRequestHandle> m_handles;
+    std::deque<std::string> m_queued;
+    std::unordered_map<std::string, Download> m_downloads;
+    std::unordered_map<std::string, web::SentAsyncWebRequestHandle> m_handles;
     std::unordered_map<CallbackID, ItemInstallCallback> m_callbacks;
-    std::vector<ghc::filesystem::path> m_downloaded;
 
     void post(UpdateStatus status, std::string const& info, uint8_t progress);
     void progress(std::string const& info, uint8_t progress);
     void error(std::string const& info);
+    void fail(std::string const& info);
     void finish(bool replaceFiles);
+    void installed(std::vector<std::pair<ghc::filesystem::path, Result<ModInfo>>> const& files);
+
+    void startQueued();
+    void download(std::string const& id);
+    void downloaded(std::string const& id);
+    void downloadProgress(std::string const& id, uint8_t progress);
+    bool downloadsDone() const;
 
     friend class Index;
 
@@ -78,14 +143,42 @@ protected:
     bool m_updating = false;
     mutable std::mutex m_callbacksMutex;
     std::vector<IndexItem> m_items;
+    // lookups into m_items, rebuilt by rebuildItemLookups() whenever it
+    // changes
+    std::unordered_map<std::string, size_t> m_itemIndices;
+    std::unordered_map<std::string, std::vector<size_t>> m_categoryItems;
+    std::unordered_map<PlatformID, std::vector<size_t>> m_platformItems;
+    SearchIndex m_search;
     std::unordered_set<InstallHandle> m_installations;
     mutable std::mutex m_ticketsMutex;
     std::unordered_set<std::string> m_featured;
     std::unordered_set<std::string> m_categories;
     std::unordered_set<std::string> m_updated;
+    IndexSource m_source;
 
     void addIndexItemFromFolder(ghc::filesystem::path const& dir);
+    void loadIndexSettings();
     Result<> updateIndexFromLocalCache();
+    void updateIndexItems(std::unordered_set<std::string> const& folders);
+    void rebuildItemLookups();
+
+    bool loadIndexSnapshot(std::string const& commit);
+    void saveIndexSnapshot(std::string const& commit) const;
+
+    void downloadIndexManifest(std::string const& commit, IndexUpdateCallback callback);
+    void downloadFullIndex(
+        std::string const& commit, std::optional<nlohmann::json> const& manifest,
+        IndexUpdateCallback callback
+    );
+    void patchIndex(
+        std::string const& commit, IndexManifest const& local, nlohmann::json const& remote,
+        IndexUpdateCallback callback
+    );
+    void applyIndexPatch(
+        std::string const& commit, std::unordered_set<std::string> const& changed,
+        std::unordered_set<std::string> const& removed, bool settingsChanged,
+        nlohmann::json const& manifest, IndexUpdateCallback callback
+    );
 
     Result<std::vector<std::string>> checkDependenciesForItem(IndexItem const& item);
 
@@ -94,12 +187,23 @@ protected:
 public:
     static Index* get();
 
-    std::vector<IndexItem> getItems() const;
+    std::span<IndexItem const> getItems() const;
     bool isKnownItem(std::string const& id) const;
-    IndexItem getKnownItem(std::string const& id) const;
-
-    std::unordered_set<std::string> getCategories() const;
-    std::vector<IndexItem> getFeaturedItems() const;
+    /**
+     * Returns an empty item if the ID isn't in the index
+     */
+    IndexItem const& getKnownItem(std::string const& id) const;
+
+    std::unordered_set<std::string> const& getCategories() const;
+    std::vector<IndexItem const*> getItemsInCategory(std::string const& category) const;
+    std::vector<IndexItem const*> getItemsForPlatform(PlatformID platform) const;
+    std::vector<IndexItem const*> getFeaturedItems() const;
+    /**
+     * Search the items of the index, best matches first
+     */
+    std::vector<IndexItem const*> searchItems(
+        std::string const& query, SearchIndex::Fields fields = SearchIndex::ALL_FIELDS
+    ) const;
     bool isFeaturedItem(std::string const& item) const;
 
     Result<InstallHandle> installItems(std::vector<IndexItem> const& item);
@@ -114,4 +218,7 @@ public:
 
     bool isIndexUpdated() const;
     void updateIndex(IndexUpdateCallback callback, bool force = false);
+
+    IndexSource getSource() const;
+    void setSource(IndexSource const& source);
 };
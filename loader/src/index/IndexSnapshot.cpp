@@ -0,0 +1,236 @@
+#include "Index.hpp"
+
+#include <Geode/loader/Loader.hpp>
+#include <Geode/utils/file.hpp>
+#include <Geode/utils/trace.hpp>
+#include <chrono>
+
+USE_GEODE_NAMESPACE();
+
+// The parsed index is saved as a single file so loading it doesn't have to
+// open and parse a handful of files for every entry. Everything is stored as
+// little-endian u32s and length-prefixed strings in one flat buffer, so the
+// file can be read (or mapped) in one go and strings referenced in place.
+//
+// header:   magic, format version, loader version, commit, featured ids
+// entries:  folder, mod.json as CBOR, about / changelog / support,
+//           download url / name / hash, platforms, categories
+
+static constexpr uint32_t SNAPSHOT_MAGIC = 0x58444947; // "GIDX"
+// bump whenever the layout above changes
+static constexpr uint32_t SNAPSHOT_VERSION = 1;
+
+namespace {
+    class SnapshotWriter {
+    protected:
+        byte_array m_data;
+
+    public:
+        void u32(uint32_t value) {
+            for (size_t i = 0; i < 4; i++) {
+                m_data.push_back(static_cast<uint8_t>(value >> (i * 8)));
+            }
+        }
+
+        void bytes(uint8_t const* data, size_t size) {
+            this->u32(static_cast<uint32_t>(size));
+            m_data.insert(m_data.end(), data, data + size);
+        }
+
+        void string(std::string_view str) {
+            this->bytes(reinterpret_cast<uint8_t const*>(str.data()), str.size());
+        }
+
+        void optional(std::optional<std::string> const& str) {
+            this->u32(str.has_value());
+            if (str) this->string(str.value());
+        }
+
+        byte_array const& data() const {
+            return m_data;
+        }
+    };
+
+    class SnapshotReader {
+    protected:
+        uint8_t const* m_cursor;
+        uint8_t const* m_end;
+        bool m_failed = false;
+
+    public:
+        SnapshotReader(byte_array const& data) :
+            m_cursor(data.data()), m_end(data.data() + data.size()) {}
+
+        bool failed() const {
+            return m_failed;
+        }
+
+        uint32_t u32() {
+            if (m_end - m_cursor < 4) {
+                m_failed = true;
+                return 0;
+            }
+            uint32_t value = 0;
+            for (size_t i = 0; i < 4; i++) {
+                value |= static_cast<uint32_t>(*m_cursor++) << (i * 8);
+            }
+            return value;
+        }
+
+        std::string_view string() {
+            auto size = this->u32();
+            if (static_cast<size_t>(m_end - m_cursor) < size) {
+                m_failed = true;
+                return {};
+            }
+            auto str = std::string_view(reinterpret_cast<char const*>(m_cursor), size);
+            m_cursor += size;
+            return str;
+        }
+
+        std::optional<std::string> optional() {
+            if (!this->u32()) return std::nullopt;
+            return std::string(this->string());
+        }
+    };
+}
+
+static ghc::filesystem::path snapshotPath() {
+    return Loader::get()->getGeodeSaveDirectory() / GEODE_INDEX_DIRECTORY / "index.bin";
+}
+
+void Index::saveIndexSnapshot(std::string const& commit) const {
+    GEODE_TRACE_ZONE("index::save-snapshot");
+
+    SnapshotWriter writer;
+    writer.u32(SNAPSHOT_MAGIC);
+    writer.u32(SNAPSHOT_VERSION);
+    writer.string(Loader::getVersion().toString());
+    writer.string(commit);
+
+    writer.u32(static_cast<uint32_t>(m_featured.size()));
+    for (auto& id : m_featured) {
+        writer.string(id);
+    }
+
+    writer.u32(static_cast<uint32_t>(m_items.size()));
+    for (auto& item : m_items) {
+        writer.string(item.m_path.filename().string());
+        auto json = ModJson::to_cbor(item.m_info.getRawJSON());
+        writer.bytes(json.data(), json.size());
+        writer.optional(item.m_info.m_details);
+        writer.optional(item.m_info.m_changelog);
+        writer.optional(item.m_info.m_supportInfo);
+
+        writer.string(item.m_download.m_url);
+        writer.string(item.m_download.m_filename);
+        writer.string(item.m_download.m_hash);
+        writer.u32(static_cast<uint32_t>(item.m_download.m_platforms.size()));
+        for (auto& platform : item.m_download.m_platforms) {
+            writer.u32(static_cast<uint32_t>(platform.m_value));
+        }
+        writer.u32(static_cast<uint32_t>(item.m_categories.size()));
+        for (auto& category : item.m_categories) {
+            writer.string(category);
+        }
+    }
+
+    auto res = utils::file::writeBinary(snapshotPath(), writer.data());
+    if (!res) {
+        log::warn("Unable to save index snapshot: {}", res.unwrapErr());
+    }
+}
+
+bool Index::loadIndexSnapshot(std::string const& commit) {
+    GEODE_TRACE_ZONE("index::load-snapshot");
+    auto start = std::chrono::steady_clock::now();
+
+    auto path = snapshotPath();
+    if (!ghc::filesystem::exists(path)) {
+        return false;
+    }
+    auto data = utils::file::readBinary(path);
+    if (!data) {
+        log::warn("Unable to read index snapshot: {}", data.unwrapErr());
+        return false;
+    }
+    auto bytes = data.unwrap();
+    SnapshotReader reader(bytes);
+
+    // a snapshot of another commit or made by another loader version (which
+    // may parse mod.json differently) is just as good as none
+    if (reader.u32() != SNAPSHOT_MAGIC || reader.u32() != SNAPSHOT_VERSION ||
+        reader.string() != Loader::getVersion().toString() || reader.string() != commit) {
+        return false;
+    }
+
+    std::unordered_set<std::string> featured;
+    for (auto count = reader.u32(); count && !reader.failed(); count--) {
+        featured.emplace(reader.string());
+    }
+
+    auto modsDir = path.parent_path() / "index";
+    std::vector<IndexItem> items;
+    auto count = reader.u32();
+    // every entry takes at least a few dozen bytes, so an absurd count means
+    // the file is corrupt rather than something to reserve memory for
+    if (count > bytes.size()) {
+        return false;
+    }
+    items.reserve(count);
+    for (; count && !reader.failed(); count--) {
+        IndexItem item;
+        item.m_path = modsDir / std::string(reader.string());
+
+        auto json = reader.string();
+        auto details = reader.optional();
+        auto changelog = reader.optional();
+        auto support = reader.optional();
+        if (reader.failed()) {
+            break;
+        }
+        try {
+            auto info = ModInfo::create(ModJson::from_cbor(json.begin(), json.end()));
+            if (!info) {
+                log::warn("Index snapshot is invalid: {}", info.unwrapErr());
+                return false;
+            }
+            item.m_info = info.unwrap();
+        }
+        catch (std::exception& e) {
+            log::warn("Index snapshot is invalid: {}", e.what());
+            return false;
+        }
+        item.m_info.m_path = item.m_path / "mod.json";
+        item.m_info.m_details = details;
+        item.m_info.m_changelog = changelog;
+        item.m_info.m_supportInfo = support;
+
+        item.m_download.m_url = reader.string();
+        item.m_download.m_filename = reader.string();
+        item.m_download.m_hash = reader.string();
+        for (auto count = reader.u32(); count && !reader.failed(); count--) {
+            item.m_download.m_platforms.insert(PlatformID::from(static_cast<int>(reader.u32())));
+        }
+        for (auto count = reader.u32(); count && !reader.failed(); count--) {
+            item.m_categories.emplace(reader.string());
+        }
+        items.push_back(std::move(item));
+    }
+    if (reader.failed()) {
+        log::warn("Index snapshot is truncated");
+        return false;
+    }
+
+    m_items = std::move(items);
+    m_featured = std::move(featured);
+    this->rebuildItemLookups();
+
+    log::info(
+        "Index loaded from snapshot ({} entries) in {}ms", m_items.size(),
+        std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - start
+        ).count()
+    );
+    return true;
+}
@@ -0,0 +1,236 @@
+#include "SearchIndex.hpp"
+
+#include <algorithm>
+#include <optional>
+
+static char fold(char c) {
+    auto u = static_cast<unsigned char>(c);
+    return u >= 'A' && u <= 'Z' ? static_cast<char>(u - 'A' + 'a') : c;
+}
+
+static std::string fold(std::string_view text) {
+    std::string ret(text.size(), '\0');
+    std::transform(text.begin(), text.end(), ret.begin(), [](char c) {
+        return fold(c);
+    });
+    return ret;
+}
+
+static bool isWordChar(char c) {
+    auto u = static_cast<unsigned char>(c);
+    // anything outside of ASCII is most likely a part of a word
+    return u >= 0x80 || (u >= '0' && u <= '9') || (u >= 'a' && u <= 'z') ||
+        (u >= 'A' && u <= 'Z');
+}
+
+static uint32_t trigram(char const* str) {
+    return static_cast<uint32_t>(static_cast<unsigned char>(str[0])) << 16 |
+        static_cast<uint32_t>(static_cast<unsigned char>(str[1])) << 8 |
+        static_cast<uint32_t>(static_cast<unsigned char>(str[2]));
+}
+
+void SearchIndex::clear() {
+    m_texts.clear();
+    m_trigrams.clear();
+    m_words.clear();
+    m_wordPostings.clear();
+    m_pendingWords.clear();
+}
+
+void SearchIndex::reserve(size_t count) {
+    m_texts.reserve(count);
+}
+
+size_t SearchIndex::size() const {
+    return m_texts.size();
+}
+
+size_t SearchIndex::add(ModInfo const& info) {
+    auto document = m_texts.size();
+    m_texts.emplace_back();
+    this->addField(document, Field::Name, info.m_name);
+    this->addField(document, Field::ID, info.m_id);
+    this->addField(document, Field::Developer, info.m_developer);
+    this->addField(document, Field::Description, info.m_description.value_or(""));
+    this->addField(document, Field::Details, info.m_details.value_or(""));
+    return document;
+}
+
+void SearchIndex::addField(size_t document, Field field, std::string_view text) {
+    auto& folded = m_texts[document][field] = fold(text);
+    auto posting = static_cast<Posting>(document * FIELD_COUNT + field);
+
+    // fields of a document are added one at a time, so a posting that is
+    // already in a list can only be the last one
+    for (size_t i = 0; i + 3 <= folded.size(); i++) {
+        auto& postings = m_trigrams[trigram(folded.data() + i)];
+        if (postings.empty() || postings.back() != posting) {
+            postings.push_back(posting);
+        }
+    }
+
+    for (size_t i = 0; i < folded.size();) {
+        if (!isWordChar(folded[i])) {
+            i++;
+            continue;
+        }
+        auto end = i;
+        while (end < folded.size() && isWordChar(folded[end])) {
+            end++;
+        }
+        auto& postings = m_pendingWords[folded.substr(i, end - i)];
+        if (postings.empty() || postings.back() != posting) {
+            postings.push_back(posting);
+        }
+        i = end;
+    }
+}
+
+void SearchIndex::finish() {
+    if (m_pendingWords.empty()) return;
+
+    // documents added earlier have lower numbers, so their postings go first
+    for (size_t i = 0; i < m_words.size(); i++) {
+        auto& postings = m_pendingWords[m_words[i]];
+        postings.insert(postings.begin(), m_wordPostings[i].begin(), m_wordPostings[i].end());
+    }
+    m_words.clear();
+    m_wordPostings.clear();
+
+    std::vector<std::pair<std::string, std::vector<Posting>>> words(
+        std::make_move_iterator(m_pendingWords.begin()),
+        std::make_move_iterator(m_pendingWords.end())
+    );
+    m_pendingWords.clear();
+    std::sort(words.begin(), words.end(), [](auto const& a, auto const& b) {
+        return a.first < b.first;
+    });
+    m_words.reserve(words.size());
+    m_wordPostings.reserve(words.size());
+    for (auto& [word, postings] : words) {
+        m_words.push_back(std::move(word));
+        m_wordPostings.push_back(std::move(postings));
+    }
+}
+
+// a field that matches at all scores at least 1, so it counts for more
+// than one that doesn't
+std::optional<uint32_t> SearchIndex::matchQuality(std::string_view text, std::string_view term) {
+    std::optional<uint32_t> quality;
+    for (auto pos = text.find(term); pos != std::string_view::npos;
+         pos = text.find(term, pos + 1)) {
+        if (!quality) quality = 1;
+        auto end = pos + term.size();
+        if (pos == 0 || !isWordChar(text[pos - 1])) {
+            if (end == text.size() || !isWordChar(text[end])) {
+                return 3;
+            }
+            quality = 2;
+        }
+    }
+    return quality;
+}
+
+std::vector<SearchIndex::Hit> SearchIndex::findTerm(std::string_view term, Fields fields) const {
+    std::vector<Hit> hits;
+    auto wanted = [&](Posting posting) {
+        return fields & (1 << (posting % FIELD_COUNT));
+    };
+
+    if (term.size() >= 3) {
+        // every trigram of the term has to be in the text, so the rarest one
+        // gives the fewest candidates to check
+        std::vector<Posting> const* candidates = nullptr;
+        for (size_t i = 0; i + 3 <= term.size(); i++) {
+            auto it = m_trigrams.find(trigram(term.data() + i));
+            if (it == m_trigrams.end()) {
+                return hits;
+            }
+            if (!candidates || it->second.size() < candidates->size()) {
+                candidates = &it->second;
+            }
+        }
+        for (auto& posting : *candidates) {
+            if (!wanted(posting)) continue;
+            auto field = static_cast<Field>(posting % FIELD_COUNT);
+            if (auto quality = matchQuality(m_texts[posting / FIELD_COUNT][field], term)) {
+                hits.push_back({ posting, quality.value() });
+            }
+        }
+        return hits;
+    }
+
+    // too short for trigrams, so match the start of words instead. whether
+    // it's the whole word is known from the word itself
+    for (auto it = std::lower_bound(m_words.begin(), m_words.end(), term);
+         it != m_words.end() && std::string_view(*it).substr(0, term.size()) == term; it++) {
+        uint32_t quality = it->size() == term.size() ? 3 : 2;
+        for (auto& posting : m_wordPostings[it - m_words.begin()]) {
+            if (wanted(posting)) {
+                hits.push_back({ posting, quality });
+            }
+        }
+    }
+    // a field may contain many words with the prefix, only count the best
+    std::sort(hits.begin(), hits.end(), [](auto const& a, auto const& b) {
+        return a.m_posting < b.m_posting ||
+            (a.m_posting == b.m_posting && a.m_quality > b.m_quality);
+    });
+    hits.erase(
+        std::unique(
+            hits.begin(), hits.end(),
+            [](auto const& a, auto const& b) {
+                return a.m_posting == b.m_posting;
+            }
+        ),
+        hits.end()
+    );
+    return hits;
+}
+
+std::vector<SearchIndex::Match> SearchIndex::search(std::string_view query, Fields fields) const {
+    std::vector<std::string> terms;
+    auto folded = fold(query);
+    for (size_t i = 0; i < folded.size();) {
+        auto end = folded.find_first_of(" \t\n", i);
+        if (end == std::string::npos) end = folded.size();
+        if (end > i) {
+            terms.push_back(folded.substr(i, end - i));
+        }
+        i = end + 1;
+    }
+
+    std::vector<Match> matches;
+    if (terms.empty()) {
+        for (size_t i = 0; i < m_texts.size(); i++) {
+            matches.push_back({ i, {} });
+        }
+        return matches;
+    }
+
+    std::vector<Score> scores(m_texts.size());
+    std::vector<uint32_t> matchedTerms(m_texts.size());
+    for (auto& term : terms) {
+        // postings are sorted by document, so each document's fields are
+        // next to each other
+        size_t last = m_texts.size();
+        for (auto& hit : this->findTerm(term, fields)) {
+            auto document = hit.m_posting / FIELD_COUNT;
+            scores[document][hit.m_posting % FIELD_COUNT] += hit.m_quality;
+            if (document != last) {
+                matchedTerms[document] += 1;
+                last = document;
+            }
+        }
+    }
+
+    for (size_t i = 0; i < m_texts.size(); i++) {
+        if (matchedTerms[i] == terms.size()) {
+            matches.push_back({ i, scores[i] });
+        }
+    }
+    std::stable_sort(matches.begin(), matches.end(), [](auto const& a, auto const& b) {
+        return a.m_score > b.m_score;
+    });
+    return matches;
+}
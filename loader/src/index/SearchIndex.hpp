@@ -0,0 +1,92 @@
+#pragma once
+
+#include <Geode/loader/ModInfo.hpp>
+#include <array>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+USE_GEODE_NAMESPACE();
+
+/**
+ * Full-text index over the searchable fields of mods, built once so that
+ * searching doesn't have to case-fold every mod's texts on every query.
+ *
+ * A query is split into terms on whitespace, and a mod matches if every
+ * term is found in at least one of the searched fields. Terms of three or
+ * more characters are matched anywhere in the text (found through the
+ * trigrams of the text), shorter ones only at the start of a word
+ */
+class SearchIndex final {
+public:
+    enum Field : uint8_t {
+        Name,
+        ID,
+        Developer,
+        Description,
+        Details,
+    };
+    static constexpr size_t FIELD_COUNT = 5;
+
+    using Fields = uint32_t;
+    static constexpr Fields ALL_FIELDS = (1 << FIELD_COUNT) - 1;
+
+    /**
+     * How well a document matches in each field. Scores are compared
+     * field by field, so a match in the name always ranks above a document
+     * that only matches elsewhere, however many other fields match
+     */
+    using Score = std::array<uint32_t, FIELD_COUNT>;
+
+    struct Match {
+        /**
+         * Index of the document in the order it was added
+         */
+        size_t m_document;
+        Score m_score;
+    };
+
+protected:
+    // postings are document * FIELD_COUNT + field
+    using Posting = uint32_t;
+
+    struct Hit {
+        Posting m_posting;
+        // whole word > start of a word > anywhere else
+        uint32_t m_quality;
+    };
+
+    std::vector<std::array<std::string, FIELD_COUNT>> m_texts;
+    std::unordered_map<uint32_t, std::vector<Posting>> m_trigrams;
+    // sorted so words can be looked up by prefix
+    std::vector<std::string> m_words;
+    std::vector<std::vector<Posting>> m_wordPostings;
+    std::unordered_map<std::string, std::vector<Posting>> m_pendingWords;
+
+    void addField(size_t document, Field field, std::string_view text);
+    static std::optional<uint32_t> matchQuality(std::string_view text, std::string_view term);
+    std::vector<Hit> findTerm(std::string_view term, Fields fields) const;
+
+public:
+    void clear();
+    void reserve(size_t count);
+    /**
+     * Add a mod to the index. Documents are numbered in the order they're
+     * added
+     */
+    size_t add(ModInfo const& info);
+    /**
+     * Must be called after adding documents and before searching
+     */
+    void finish();
+
+    /**
+     * Find the documents matching a query, best matches first. Matches in
+     * the name weigh the most, then ID, developer, description and details
+     */
+    std::vector<Match> search(std::string_view query, Fields fields = ALL_FIELDS) const;
+
+    size_t size() const;
+};
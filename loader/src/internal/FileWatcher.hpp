@@ -22,6 +22,18 @@ protected:
     void watch();
 
 public:
+    /**
+     * Whether the callbacks are already called on the GD thread. Only the
+     * inotify backend delivers them there, the others call them from the
+     * thread that waits for changes
+     */
+    static constexpr bool CALLS_BACK_IN_GD_THREAD =
+#ifdef __linux__
+        true;
+#else
+        false;
+#endif
+
     bool watching() const;
 
     ghc::filesystem::path path() {
@@ -0,0 +1,11 @@
+#include "SymbolMap.hpp"
+
+#include <Geode/GeneratedSymbols.hpp>
+
+SymbolMap const& SymbolMap::game() {
+    static SymbolMap map(
+        GENERATED_SYMBOL_OFFSETS.data(), GENERATED_SYMBOL_NAMES.data(),
+        GENERATED_SYMBOL_OFFSETS.size()
+    );
+    return map;
+}
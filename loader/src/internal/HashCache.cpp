@@ -0,0 +1,104 @@
+#include "HashCache.hpp"
+
+#include <Geode/external/json/json.hpp>
+#include <Geode/loader/Loader.hpp>
+#include <Geode/loader/Log.hpp>
+#include <Geode/utils/file.hpp>
+#include <Geode/utils/trace.hpp>
+#include <hash.hpp>
+
+USE_GEODE_NAMESPACE();
+
+HashCache* HashCache::get() {
+    static auto inst = new HashCache;
+    return inst;
+}
+
+void HashCache::load() {
+    if (m_loaded) return;
+    m_loaded = true;
+    m_file = Loader::get()->getGeodeSaveDirectory() / "hashes.json";
+
+    if (!ghc::filesystem::exists(m_file)) return;
+    auto data = utils::file::readString(m_file);
+    if (!data) return;
+    try {
+        auto json = nlohmann::json::parse(data.unwrap());
+        for (auto& [key, value] : json.items()) {
+            m_entries.insert({ key,
+                               Entry {
+                                   value.at("size").get<uintmax_t>(),
+                                   value.at("modified").get<int64_t>(),
+                                   value.at("hash").get<std::string>(),
+                               } });
+        }
+    }
+    catch (std::exception& e) {
+        // just a cache, start over
+        log::warn("Unable to read hash cache: {}", e.what());
+        m_entries.clear();
+    }
+}
+
+std::vector<std::string> HashCache::hash(
+    std::vector<ghc::filesystem::path> const& paths, std::string const& algorithm, HashFunc func
+) {
+    GEODE_TRACE_ZONE("hash-cache::hash");
+    std::lock_guard lock(m_mutex);
+    this->load();
+
+    std::vector<std::string> hashes(paths.size());
+    std::vector<std::string> keys(paths.size());
+    std::vector<Entry> stats(paths.size());
+    std::vector<size_t> missing;
+    for (size_t i = 0; i < paths.size(); i++) {
+        std::error_code ec;
+        auto size = ghc::filesystem::file_size(paths[i], ec);
+        auto modified = ghc::filesystem::last_write_time(paths[i], ec);
+        keys[i] = algorithm + ":" + paths[i].string();
+        stats[i] = { size, static_cast<int64_t>(modified.time_since_epoch().count()), "" };
+
+        auto it = m_entries.find(keys[i]);
+        if (!ec && it != m_entries.end() && it->second.m_size == stats[i].m_size &&
+            it->second.m_modified == stats[i].m_modified) {
+            hashes[i] = it->second.m_hash;
+        }
+        else {
+            missing.push_back(i);
+        }
+    }
+
+    std::vector<ghc::filesystem::path> toHash;
+    for (auto& i : missing) {
+        toHash.push_back(paths[i]);
+    }
+    auto computed = calculateHashes(toHash, func);
+    for (size_t j = 0; j < missing.size(); j++) {
+        auto i = missing[j];
+        hashes[i] = computed[j];
+        // unreadable files hash to nothing, don't remember that
+        if (hashes[i].size()) {
+            stats[i].m_hash = hashes[i];
+            m_entries.insert_or_assign(keys[i], stats[i]);
+            m_dirty = true;
+        }
+    }
+    return hashes;
+}
+
+Result<> HashCache::save() {
+    std::lock_guard lock(m_mutex);
+    if (!m_dirty) return Ok();
+
+    auto json = nlohmann::json::object();
+    for (auto& [key, entry] : m_entries) {
+        json[key] = {
+            { "size", entry.m_size },
+            { "modified", entry.m_modified },
+            { "hash", entry.m_hash },
+        };
+    }
+    GEODE_UNWRAP(utils::file::writeString(m_file, json.dump()));
+    m_dirty = false;
+    return Ok();
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <Geode/utils/Result.hpp>
+#include <fs/filesystem.hpp>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Remembers the hashes of files by their path, size and modification time,
+ * so files that haven't changed since the last launch aren't hashed again
+ */
+class HashCache final {
+protected:
+    struct Entry {
+        uintmax_t m_size;
+        int64_t m_modified;
+        std::string m_hash;
+    };
+
+    std::mutex m_mutex;
+    ghc::filesystem::path m_file;
+    bool m_loaded = false;
+    bool m_dirty = false;
+    std::unordered_map<std::string, Entry> m_entries;
+
+    void load();
+
+public:
+    using HashFunc = std::string (*)(ghc::filesystem::path const&);
+
+    static HashCache* get();
+
+    /**
+     * Get the hashes of files, only hashing the ones that changed (in
+     * parallel)
+     * @param algorithm Name of the algorithm, to keep hashes made with
+     * different ones apart
+     * @returns The hashes in the same order as the paths
+     */
+    std::vector<std::string> hash(
+        std::vector<ghc::filesystem::path> const& paths, std::string const& algorithm,
+        HashFunc func
+    );
+
+    /**
+     * Write the cache to disk, if anything was added to it
+     */
+    geode::Result<> save();
+};
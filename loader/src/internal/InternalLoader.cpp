@@ -11,7 +11,9 @@
 #include <Geode/loader/Log.hpp>
 #include <Geode/utils/web.hpp>
 #include <Geode/utils/file.hpp>
+#include <Geode/utils/trace.hpp>
 
+#include "HashCache.hpp"
 #include "InternalLoader.hpp"
 #include "InternalMod.hpp"
 #include "resources.hpp"
@@ -55,7 +57,197 @@ void InternalLoader::addInternalHook(Hook* hook, Mod* mod) {
     m_internalHooks.push_back({hook, mod});
 }
 
+Mod* InternalLoader::getLoadingMod() const {
+    return m_loadingMod;
+}
+
+void InternalLoader::setLoadingMod(Mod* mod) {
+    m_loadingMod = mod;
+}
+
+void InternalLoader::loadModResources(Mod* mod) {
+    // the mod may be unloaded and loaded again before the queue runs, in
+    // which case only the latest load should add its resources back
+    mod->m_resourcesQueued = true;
+    this->queueInGDThread([this, mod]() {
+        if (!mod->m_resourcesQueued || !mod->isLoaded()) {
+            return;
+        }
+        mod->m_resourcesQueued = false;
+        auto searchPath = this->getGeodeDirectory() /
+            GEODE_TEMP_DIRECTORY / mod->getID() / "resources";
+
+        CCFileUtils::get()->addSearchPath(searchPath.string().c_str());
+        this->updateModResources(mod);
+    });
+}
+
+size_t InternalLoader::freeModResources(Mod* mod) {
+    auto ccfu = CCFileUtils::get();
+    size_t freed = 0;
+    // frames and textures have to go first, as they are looked up
+    // through the search path
+    for (auto const& sheet : mod->m_info.m_spritesheets) {
+        auto png = sheet + ".png";
+        auto plist = sheet + ".plist";
+        if (png == std::string(ccfu->fullPathForFilename(png.c_str(), false))) {
+            continue;
+        }
+        CCSpriteFrameCache::get()->removeSpriteFramesFromFile(plist.c_str());
+        CCTextureCache::get()->removeTextureForKey(png.c_str());
+        freed += 1;
+    }
+
+    auto searchPath = this->getGeodeDirectory() /
+        GEODE_TEMP_DIRECTORY / mod->getID() / "resources";
+    ccfu->removeSearchPath(searchPath.string().c_str());
+
+    return freed;
+}
+
+size_t InternalLoader::discardScheduledFunctions(Mod* mod) {
+    std::lock_guard _(m_scheduledFunctionsMutex);
+    auto count = m_scheduledFunctions.size();
+    m_scheduledFunctions.erase(
+        std::remove_if(
+            m_scheduledFunctions.begin(), m_scheduledFunctions.end(),
+            [&](auto const& scheduled) {
+                return scheduled.first == mod;
+            }
+        ),
+        m_scheduledFunctions.end()
+    );
+    return count - m_scheduledFunctions.size();
+}
+
+void InternalLoader::watchModsDirectory() {
+    if (m_modDirectoryWatcher) {
+        return;
+    }
+    m_modDirectoryWatcher = std::make_unique<FileWatcher>(
+        this->getGeodeDirectory() / GEODE_MOD_DIRECTORY,
+        [](ghc::filesystem::path const& file) {
+            if (FileWatcher::CALLS_BACK_IN_GD_THREAD) {
+                InternalLoader::get()->onModsDirectoryChanged(file);
+            }
+            else {
+                Loader::get()->queueInGDThread([file]() {
+                    InternalLoader::get()->onModsDirectoryChanged(file);
+                });
+            }
+        },
+        [](std::string const& err) {
+            log::error("Unable to watch mods directory: {}", err);
+        }
+    );
+}
+
+void InternalLoader::onModsDirectoryChanged(ghc::filesystem::path const& file) {
+    // backends that can't tell which file changed report the directory
+    // itself, in which case every package has to be checked
+    auto wholeDirectory = ghc::filesystem::is_directory(file);
+    for (auto& mod : m_mods) {
+        if (wholeDirectory || mod->m_info.m_path == file) {
+            mod->m_uninstalled = !ghc::filesystem::exists(mod->m_info.m_path);
+        }
+    }
+    if (m_hotReloadMods) {
+        this->reloadModFromFile(file);
+    }
+}
+
+void InternalLoader::setHotReloadMods(bool enabled) {
+    m_hotReloadMods = enabled;
+}
+
+void InternalLoader::reloadModFromFile(ghc::filesystem::path const& file) {
+    // backends that can't tell which file changed report the directory
+    // itself, in which case just pick up any new mods
+    if (ghc::filesystem::is_directory(file)) {
+        auto res = this->refreshModsList();
+        if (!res) {
+            log::error("Unable to refresh mods: {}", res.unwrapErr());
+        }
+        return;
+    }
+    if (file.extension() != GEODE_MOD_EXTENSION) {
+        return;
+    }
+
+    Mod* mod = nullptr;
+    for (auto& m : m_mods) {
+        if (m->m_info.m_path == file) {
+            mod = m;
+            break;
+        }
+    }
+
+    if (!ghc::filesystem::exists(file)) {
+        if (mod) {
+            log::info("Package for {} was removed, unloading", mod->getID());
+            auto res = mod->unloadBinary();
+            if (!res) {
+                log::warn("Unable to unload {}: {}", mod->getID(), res.unwrapErr());
+            }
+        }
+        return;
+    }
+
+    if (!mod) {
+        auto res = this->loadModFromFile(file);
+        if (!res) {
+            log::error("Unable to load {}: {}", file, res.unwrapErr());
+        }
+        return;
+    }
+
+    auto infoRes = ModInfo::createFromGeodeFile(file);
+    if (!infoRes) {
+        log::error("Unable to reload {}: {}", mod->getID(), infoRes.unwrapErr());
+        return;
+    }
+    auto info = infoRes.unwrap();
+    if (info.m_id != mod->getID()) {
+        log::warn(
+            "Package {} changed its ID from {} to {}, restart the game to apply this",
+            file, mod->getID(), info.m_id
+        );
+        return;
+    }
+    if (mod->isLoaded() && !mod->supportsUnloading()) {
+        log::warn("{} does not support unloading, restart the game to apply changes", mod->getID());
+        return;
+    }
+
+    log::info("Reloading {}", mod->getID());
+
+    auto wasLoaded = mod->isLoaded();
+    auto unload = mod->unloadBinary();
+    if (!unload) {
+        log::error("Unable to unload {}: {}", mod->getID(), unload.unwrapErr());
+        return;
+    }
+
+    // force the package to be extracted again
+    if (!mod->m_tempDirName.empty()) {
+        std::error_code ec;
+        ghc::filesystem::remove_all(mod->m_tempDirName, ec);
+        mod->m_tempDirName.clear();
+    }
+    mod->m_info = info;
+
+    if (wasLoaded) {
+        auto load = mod->loadBinary();
+        if (!load) {
+            log::error("Unable to reload {}: {}", mod->getID(), load.unwrapErr());
+            return;
+        }
+    }
+}
+
 bool InternalLoader::loadHooks() {
+    GEODE_TRACE_ZONE("InternalLoader::loadHooks");
+
     m_readyToHook = true;
     auto thereWereErrors = false;
     for (auto const& hook : m_internalHooks) {
@@ -72,14 +264,14 @@ bool InternalLoader::loadHooks() {
 
 void InternalLoader::queueInGDThread(ScheduledFunction func) {
     std::lock_guard<std::mutex> lock(m_gdThreadMutex);
-    m_gdThreadQueue.push_back(func);
+    m_gdThreadQueue.push_back(std::move(func));
 }
 
 void InternalLoader::executeGDThreadQueue() {
-    // copy queue to avoid locking mutex if someone is
+    // take the queue to avoid locking mutex if someone is
     // running addToGDThread inside their function
     m_gdThreadMutex.lock();
-    auto queue = m_gdThreadQueue;
+    auto queue = std::move(m_gdThreadQueue);
     m_gdThreadQueue.clear();
     m_gdThreadMutex.unlock();
 
@@ -178,19 +370,21 @@ bool InternalLoader::verifyLoaderResources(IndexUpdateCallback callback) {
     // make sure every file was covered
     size_t coverage = 0;
 
-    // verify hashes
+    // skip unknown files
+    std::vector<ghc::filesystem::path> files;
     for (auto& file : ghc::filesystem::directory_iterator(resourcesDir)) {
-        auto name = file.path().filename().string();
-        // skip unknown files
-        if (!LOADER_RESOURCE_HASHES.count(name)) {
-            continue;
+        if (LOADER_RESOURCE_HASHES.count(file.path().filename().string())) {
+            files.push_back(file.path());
         }
-        // verify hash
-        auto hash = calculateSHA256(file.path());
-        if (hash != LOADER_RESOURCE_HASHES.at(name)) {
-            log::debug(
-                "compare {} {} {}", file.path().string(), hash, LOADER_RESOURCE_HASHES.at(name)
-            );
+    }
+
+    // verify hashes, only rehashing files that changed since the last check
+    auto hashes = HashCache::get()->hash(files, "sha256", calculateSHA256);
+    (void)HashCache::get()->save();
+    for (size_t i = 0; i < files.size(); i++) {
+        auto& expected = LOADER_RESOURCE_HASHES.at(files[i].filename().string());
+        if (hashes[i] != expected) {
+            log::debug("compare {} {} {}", files[i].string(), hashes[i], expected);
             this->downloadLoaderResources(callback);
             return false;
         }
@@ -8,6 +8,7 @@
 #include <Geode/utils/Result.hpp>
 #include <Geode/external/json/json.hpp>
 
+#include <memory>
 #include <mutex>
 #include <optional>
 #include <unordered_map>
@@ -31,6 +32,11 @@ protected:
     std::vector<std::pair<Hook*, Mod*>> m_internalHooks;
     bool m_readyToHook;
 
+    std::unique_ptr<FileWatcher> m_modDirectoryWatcher;
+    bool m_hotReloadMods = false;
+
+    Mod* m_loadingMod = nullptr;
+
     void saveInfoAlerts(nlohmann::json& json);
     void loadInfoAlerts(nlohmann::json& json);
 
@@ -72,5 +78,45 @@ public:
     bool isReadyToHook() const;
     void addInternalHook(Hook* hook, Mod* mod);
 
+    /**
+     * The mod whose binary is currently being loaded, used to attribute
+     * resources registered from static initializers to their owner
+     */
+    Mod* getLoadingMod() const;
+    void setLoadingMod(Mod* mod);
+
+    /**
+     * Add a mod's resources directory to the search paths and load its
+     * spritesheets on the GD thread
+     */
+    void loadModResources(Mod* mod);
+    /**
+     * Remove a mod's spritesheets from the texture and sprite frame
+     * caches and its resources directory from the search paths
+     * @returns Number of spritesheets removed
+     */
+    size_t freeModResources(Mod* mod);
+    /**
+     * Drop the scheduled functions of a mod that never got dispatched
+     * @returns Number of functions dropped
+     */
+    size_t discardScheduledFunctions(Mod* mod);
+
+    /**
+     * Watch the mods directory to keep mods' installed state up to
+     * date without having to stat their packages on every query
+     */
+    void watchModsDirectory();
+    void onModsDirectoryChanged(ghc::filesystem::path const& file);
+    /**
+     * Reload mods as their .geode packages change
+     */
+    void setHotReloadMods(bool enabled);
+    /**
+     * Load, reload or unload the mod whose package is at the given
+     * path depending on whether it's already loaded and still exists
+     */
+    void reloadModFromFile(ghc::filesystem::path const& file);
+
     friend int geodeEntry(void* platformData);
 };
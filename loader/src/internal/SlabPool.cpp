@@ -0,0 +1,56 @@
+#include "SlabPool.hpp"
+
+#include <algorithm>
+#include <new>
+
+SlabPool::SlabPool(size_t blockSize, size_t blocksPerChunk) :
+    m_blockSize(
+        (std::max(blockSize, sizeof(FreeBlock)) + alignof(std::max_align_t) - 1) &
+        ~(alignof(std::max_align_t) - 1)
+    ),
+    m_blocksPerChunk(blocksPerChunk) {}
+
+void* SlabPool::allocate() {
+    std::lock_guard lock(m_mutex);
+    m_live++;
+    if (m_free) {
+        auto block = m_free;
+        m_free = block->m_next;
+        return block;
+    }
+    if (!m_untouched) {
+        m_chunks.emplace_back(new std::byte[m_blockSize * m_blocksPerChunk]);
+        m_untouched = m_blocksPerChunk;
+    }
+    // hand out the blocks of a new chunk in order instead of threading
+    // them all into the free list up front
+    auto block = m_chunks.back().get() + m_blockSize * (m_blocksPerChunk - m_untouched);
+    m_untouched--;
+    return block;
+}
+
+void SlabPool::deallocate(void* block) {
+    if (!block) return;
+    std::lock_guard lock(m_mutex);
+    m_live--;
+    m_free = new (block) FreeBlock { m_free };
+}
+
+size_t SlabPool::blockSize() const {
+    return m_blockSize;
+}
+
+size_t SlabPool::live() const {
+    std::lock_guard lock(m_mutex);
+    return m_live;
+}
+
+size_t SlabPool::chunks() const {
+    std::lock_guard lock(m_mutex);
+    return m_chunks.size();
+}
+
+size_t SlabPool::reserved() const {
+    std::lock_guard lock(m_mutex);
+    return m_chunks.size() * m_blockSize * m_blocksPerChunk;
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <unordered_set>
+#include <vector>
+
+/**
+ * Hands out blocks of one size from chunks of many blocks, so lots of small
+ * objects of the same size don't each need an allocation of their own.
+ * Freed blocks are reused before new chunks are allocated, and the chunks
+ * are only freed with the pool.
+ *
+ * Pools are shared by every mod through the exported field allocator, which
+ * can be called from any thread, so all operations take a lock. It's never
+ * contended in practice, since nodes are almost always made on the GD thread
+ */
+class SlabPool final {
+protected:
+    struct FreeBlock {
+        FreeBlock* m_next;
+    };
+
+    size_t m_blockSize;
+    size_t m_blocksPerChunk;
+    std::vector<std::unique_ptr<std::byte[]>> m_chunks;
+    FreeBlock* m_free = nullptr;
+    // blocks of the last chunk that haven't been handed out yet
+    size_t m_untouched = 0;
+    size_t m_live = 0;
+    mutable std::mutex m_mutex;
+
+public:
+    /**
+     * @param blockSize Size of the blocks, rounded up so every block is
+     * aligned for any type
+     */
+    SlabPool(size_t blockSize, size_t blocksPerChunk = 256);
+
+    SlabPool(SlabPool const&) = delete;
+    SlabPool& operator=(SlabPool const&) = delete;
+
+    void* allocate();
+    void deallocate(void* block);
+
+    /**
+     * Call a function with every block that's allocated and not yet freed.
+     * Finding them takes a set of the free blocks, so this is meant for
+     * rare operations, like unloading a mod. The function must not
+     * allocate or free blocks of the same pool
+     */
+    template <class Func>
+    void forEachLive(Func&& func) {
+        std::lock_guard lock(m_mutex);
+        std::unordered_set<void*> free;
+        for (auto block = m_free; block; block = block->m_next) {
+            free.insert(block);
+        }
+        for (size_t i = 0; i < m_chunks.size(); i++) {
+            // the blocks after these in the last chunk were never handed out
+            auto count = i + 1 < m_chunks.size() ? m_blocksPerChunk : m_blocksPerChunk - m_untouched;
+            for (size_t j = 0; j < count; j++) {
+                auto block = m_chunks[i].get() + m_blockSize * j;
+                if (!free.count(block)) {
+                    func(static_cast<void*>(block));
+                }
+            }
+        }
+    }
+
+    size_t blockSize() const;
+    /**
+     * Blocks allocated and not yet freed
+     */
+    size_t live() const;
+    size_t chunks() const;
+    /**
+     * Bytes taken by the chunks, whether the blocks are in use or not
+     */
+    size_t reserved() const;
+};
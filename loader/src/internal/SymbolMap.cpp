@@ -0,0 +1,64 @@
+#include "SymbolMap.hpp"
+
+#include <bit>
+#include <cstdio>
+
+SymbolMap::SymbolMap(uint32_t const* offsets, char const* const* names, size_t count) :
+    m_tree(count + 1), m_ranks(count + 1), m_offsets(offsets, offsets + count),
+    m_names(names, names + count) {
+    this->build(1, 0);
+}
+
+// an in-order walk of the tree visits the nodes in sorted order, so filling
+// it in that walk puts every offset where a binary search would look for it
+size_t SymbolMap::build(size_t node, size_t rank) {
+    if (node < m_tree.size()) {
+        rank = this->build(node * 2, rank);
+        m_tree[node] = m_offsets[rank];
+        m_ranks[node] = static_cast<uint32_t>(rank);
+        rank = this->build(node * 2 + 1, rank + 1);
+    }
+    return rank;
+}
+
+std::optional<SymbolMap::Symbol> SymbolMap::find(uintptr_t offset) const {
+    auto const count = m_offsets.size();
+    if (!count) return std::nullopt;
+
+    // go right while the node is at or before the offset. the path ends up
+    // as the node's index followed by a 0 (the last left turn) and 1s (the
+    // right turns after it), so dropping those gives the first node after
+    // the offset
+    size_t node = 1;
+    while (node <= count) {
+        node = node * 2 + (m_tree[node] <= offset);
+    }
+    node >>= std::countr_one(node) + 1;
+
+    // no node after the offset means it's in the last function
+    auto const rank = node ? m_ranks[node] : count;
+    if (rank == 0) return std::nullopt;
+
+    // the next function bounds the match, but there's nothing to bound the
+    // last one, and functions that aren't bound leave gaps between the others
+    auto const displacement = offset - m_offsets[rank - 1];
+    if (displacement > MAX_DISPLACEMENT) return std::nullopt;
+
+    return Symbol { m_names[rank - 1], displacement, displacement > APPROXIMATE_DISPLACEMENT };
+}
+
+std::string SymbolMap::describe(uintptr_t offset) const {
+    auto const symbol = this->find(offset);
+    if (!symbol) return "";
+
+    char displacement[3 + sizeof(uintptr_t) * 2 + 1];
+    std::snprintf(
+        displacement, sizeof(displacement), "+0x%llx",
+        static_cast<unsigned long long>(symbol->m_displacement)
+    );
+    return (symbol->m_approximate ? "near " : "") + std::string(symbol->m_name) + displacement;
+}
+
+size_t SymbolMap::size() const {
+    return m_offsets.size();
+}
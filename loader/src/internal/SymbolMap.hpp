@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+/**
+ * Finds the bound function an address of the game is in, for naming
+ * addresses in crash logs and profiles without debug symbols.
+ *
+ * The offsets are searched in Eytzinger order (the layout of a binary heap),
+ * so the first few levels of the search share cache lines between lookups
+ * and every step is a branchless index calculation
+ */
+class SymbolMap final {
+public:
+    struct Symbol {
+        char const* m_name;
+        /**
+         * How far into the function the address is
+         */
+        uintptr_t m_displacement;
+        /**
+         * Only bound functions are known, so an address far into one may
+         * well be in an unbound function after it
+         */
+        bool m_approximate;
+    };
+
+    /**
+     * Addresses further than this past the start of every function aren't
+     * matched at all
+     */
+    static constexpr uintptr_t MAX_DISPLACEMENT = 0x10000;
+    /**
+     * Matches further than this into their function are approximate
+     */
+    static constexpr uintptr_t APPROXIMATE_DISPLACEMENT = 0x1000;
+
+protected:
+    // 1-indexed, the children of i are 2i and 2i + 1
+    std::vector<uint32_t> m_tree;
+    // position of each node of the tree in the sorted order
+    std::vector<uint32_t> m_ranks;
+    std::vector<uint32_t> m_offsets;
+    std::vector<char const*> m_names;
+
+    size_t build(size_t node, size_t rank);
+
+public:
+    SymbolMap() = default;
+    /**
+     * @param offsets Offsets of the functions from the base of the binary,
+     * sorted in ascending order
+     * @param names Names of the functions in the same order
+     */
+    SymbolMap(uint32_t const* offsets, char const* const* names, size_t count);
+
+    /**
+     * The map of the functions bound in the bindings, from
+     * Geode/GeneratedSymbols.hpp
+     */
+    static SymbolMap const& game();
+
+    /**
+     * Find the function an offset from the base of the binary is in, which
+     * is the last one starting at or before it, unless that's more than
+     * MAX_DISPLACEMENT before it
+     */
+    std::optional<Symbol> find(uintptr_t offset) const;
+    /**
+     * Name an offset as "Class::function+0x12", or "near Class::function+0x1234"
+     * if the match is approximate. Returns an empty string if there's no match
+     */
+    std::string describe(uintptr_t offset) const;
+
+    size_t size() const;
+};
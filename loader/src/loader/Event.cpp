@@ -1,10 +1,17 @@
 #include <Geode/loader/Event.hpp>
+#include <InternalLoader.hpp>
+#include <vector>
 
 USE_GEODE_NAMESPACE();
 
 std::unordered_set<EventListenerProtocol*> Event::s_listeners = {};
 
 void EventListenerProtocol::enable() {
+    // listeners created during static initialization run before
+    // Mod::get() has been set for their mod
+    if (!m_owner) {
+        m_owner = InternalLoader::get()->getLoadingMod();
+    }
     Event::s_listeners.insert(this);
 }
 
@@ -28,6 +35,22 @@ void Event::postFrom(Mod* m) {
     }
 }
 
+size_t Event::removeListenersOwnedBy(Mod* mod) {
+    std::vector<EventListenerProtocol*> owned;
+    for (auto listener : Event::s_listeners) {
+        if (listener->m_owner == mod) {
+            owned.push_back(listener);
+        }
+    }
+    for (auto listener : owned) {
+        listener->disable();
+        if (listener->m_autoDelete) {
+            delete listener;
+        }
+    }
+    return owned.size();
+}
+
 Mod* Event::getSender() {
     return m_sender;
 }
@@ -6,6 +6,7 @@
 #include <about.hpp>
 #include <Geode/utils/ranges.hpp>
 #include <Geode/utils/map.hpp>
+#include <Geode/utils/trace.hpp>
 #include <crashlog.hpp>
 
 USE_GEODE_NAMESPACE();
@@ -15,10 +16,11 @@ Loader* Loader::get() {
 }
 
 Loader::~Loader() {
-    for (auto& [_, mod] : m_mods) {
+    for (auto& mod : m_mods) {
         delete mod;
     }
     m_mods.clear();
+    m_modIndices.clear();
     log::Logs::clear();
     ghc::filesystem::remove_all(
         this->getGeodeDirectory() / GEODE_TEMP_DIRECTORY
@@ -72,7 +74,7 @@ void Loader::createDirectories() {
 
 Result<> Loader::saveData() {
     // save mods' data
-    for (auto& [_, mod] : m_mods) {
+    for (auto& mod : m_mods) {
         auto r = mod->saveData();
         if (!r) {
             log::warn("Unable to save data for mod \"{}\": {}", mod->getID(), r.unwrapErr());
@@ -89,7 +91,7 @@ Result<> Loader::loadData() {
     if (!e) {
         log::warn("Unable to load loader settings: {}", e.unwrapErr());
     }
-    for (auto& [_, mod] : m_mods) {
+    for (auto& mod : m_mods) {
         auto r = mod->loadData();
         if (!r) {
             log::warn("Unable to load data for mod \"{}\": {}", mod->getID(), r.unwrapErr());
@@ -103,6 +105,8 @@ Result<> Loader::setup() {
         return Ok();
     }
 
+    GEODE_TRACE_ZONE("Loader::setup");
+
     log::Logs::setup();
 
     if (crashlog::setupPlatformHandler()) {
@@ -121,6 +125,8 @@ Result<> Loader::setup() {
     }
     GEODE_UNWRAP(this->refreshModsList());
 
+    InternalLoader::get()->watchModsDirectory();
+
     this->queueInGDThread([]() {
         Loader::get()->addSearchPaths();
     });
@@ -131,13 +137,14 @@ Result<> Loader::setup() {
 }
 
 Result<Mod*> Loader::loadModFromInfo(ModInfo const& info) {
-    if (m_mods.count(info.m_id)) {
+    if (m_modIndices.count(info.m_id)) {
         return Err(fmt::format("Mod with ID '{}' already loaded", info.m_id));
     }
 
     // create Mod instance
     auto mod = new Mod(info);
-    m_mods.insert({ info.m_id, mod });
+    m_modIndices.insert({ info.m_id, m_mods.size() });
+    m_mods.push_back(mod);
     mod->m_enabled = InternalMod::get()->getSavedValue<bool>(
         "should-load-" + info.m_id, true
     );
@@ -145,13 +152,7 @@ Result<Mod*> Loader::loadModFromInfo(ModInfo const& info) {
     mod->updateDependencyStates();
 
     // add mod resources
-    this->queueInGDThread([this, mod]() {
-        auto searchPath = this->getGeodeDirectory() /
-            GEODE_TEMP_DIRECTORY / mod->getID() / "resources";
-
-        CCFileUtils::get()->addSearchPath(searchPath.string().c_str());
-        this->updateModResources(mod);
-    });
+    InternalLoader::get()->loadModResources(mod);
 
     return Ok(mod);
 }
@@ -172,6 +173,8 @@ Result<> Loader::loadModsFromDirectory(
     ghc::filesystem::path const& dir,
     bool recursive
 ) {
+    GEODE_TRACE_ZONE("Loader::loadModsFromDirectory");
+
     log::debug("Searching {}", dir);
     for (auto const& entry : ghc::filesystem::directory_iterator(dir)) {
         // recursively search directories
@@ -189,10 +192,13 @@ Result<> Loader::loadModsFromDirectory(
         if (entry.path().extension() != GEODE_MOD_EXTENSION) {
             continue;
         }
-        // skip this entry if it's already loaded
-        if (map::contains<std::string, Mod*>(m_mods, [entry](Mod* p) -> bool {
+        // skip this entry if it's already loaded, it may have been
+        // reinstalled since it was last seen though
+        auto existing = std::find_if(m_mods.begin(), m_mods.end(), [entry](Mod* p) -> bool {
             return p->m_info.m_path == entry.path();
-        })) {
+        });
+        if (existing != m_mods.end()) {
+            (*existing)->m_uninstalled = false;
             continue;
         }
 
@@ -226,7 +232,41 @@ Result<> Loader::loadModsFromDirectory(
     return Ok();
 }
 
+std::vector<Mod*> Loader::loadInstalledMods(
+    std::vector<std::pair<ghc::filesystem::path, Result<ModInfo>>> const& files
+) {
+    GEODE_TRACE_ZONE("Loader::loadInstalledMods");
+
+    std::vector<Mod*> loaded;
+    for (auto& [file, info] : files) {
+        if (!info) {
+            m_invalidMods.push_back(InvalidGeodeFile {
+                .m_path = file,
+                .m_reason = info.unwrapErr(),
+            });
+            continue;
+        }
+        // reinstalling a mod that's already loaded takes a restart
+        auto existing = std::find_if(m_mods.begin(), m_mods.end(), [&](Mod* p) -> bool {
+            return p->m_info.m_path == file;
+        });
+        if (existing != m_mods.end()) {
+            (*existing)->m_uninstalled = false;
+            continue;
+        }
+        auto res = this->loadModFromInfo(info.unwrap());
+        if (!res) {
+            log::warn("Unable to load {}: {}", file, res.unwrapErr());
+            continue;
+        }
+        loaded.push_back(res.unwrap());
+    }
+    return loaded;
+}
+
 Result<> Loader::refreshModsList() {
+    GEODE_TRACE_ZONE("Loader::refreshModsList");
+
     log::debug("Loading mods...");
 
     // find mods
@@ -255,33 +295,55 @@ Result<> Loader::refreshModsList() {
     return Ok();
 }
 
-bool Loader::isModInstalled(std::string const& id) const {
-    return m_mods.count(id) && !m_mods.at(id)->isUninstalled();
+Mod* Loader::findMod(std::string_view id) const {
+    auto found = m_modIndices.find(id);
+    if (found != m_modIndices.end()) {
+        return m_mods[found->second];
+    }
+    return nullptr;
+}
+
+bool Loader::isModInstalled(std::string_view id) const {
+    return this->getInstalledMod(id);
 }
 
-Mod* Loader::getInstalledMod(std::string const& id) const {
-    if (m_mods.count(id) && !m_mods.at(id)->isUninstalled()) {
-        return m_mods.at(id);
+Mod* Loader::getInstalledMod(std::string_view id) const {
+    auto mod = this->findMod(id);
+    if (mod && !mod->isUninstalled()) {
+        return mod;
     }
     return nullptr;
 }
 
-bool Loader::isModLoaded(std::string const& id) const {
-    return m_mods.count(id) && m_mods.at(id)->isLoaded();
+bool Loader::isModLoaded(std::string_view id) const {
+    return this->getLoadedMod(id);
 }
 
-Mod* Loader::getLoadedMod(std::string const& id) const {
-    if (m_mods.count(id)) {
-        auto mod = m_mods.at(id);
-        if (mod->isLoaded()) {
-            return mod;
-        }
+Mod* Loader::getLoadedMod(std::string_view id) const {
+    auto mod = this->findMod(id);
+    if (mod && mod->isLoaded()) {
+        return mod;
     }
     return nullptr;
 }
 
-std::vector<Mod*> Loader::getAllMods() {
-    return map::getValues(m_mods);
+std::optional<ModIndex> Loader::getModIndex(std::string_view id) const {
+    auto found = m_modIndices.find(id);
+    if (found != m_modIndices.end()) {
+        return found->second;
+    }
+    return std::nullopt;
+}
+
+Mod* Loader::getModAt(ModIndex index) const {
+    if (index < m_mods.size()) {
+        return m_mods[index];
+    }
+    return nullptr;
+}
+
+std::span<Mod* const> Loader::getAllMods() const {
+    return m_mods;
 }
 
 Mod* Loader::getInternalMod() {
@@ -293,7 +355,7 @@ std::vector<InvalidGeodeFile> Loader::getFailedMods() const {
 }
 
 void Loader::updateAllDependencies() {
-    for (auto const& [_, mod] : m_mods) {
+    for (auto const& mod : m_mods) {
         mod->updateDependencyStates();
     }
 }
@@ -304,14 +366,14 @@ void Loader::waitForModsToBeLoaded() {
 
 void Loader::dispatchScheduledFunctions(Mod* mod) {
     std::lock_guard _(m_scheduledFunctionsMutex);
-    for (auto& func : m_scheduledFunctions) {
+    for (auto& [_, func] : m_scheduledFunctions) {
         func();
     }
     m_scheduledFunctions.clear();
 }
 
 void Loader::queueInGDThread(ScheduledFunction func) {
-    InternalLoader::get()->queueInGDThread(func);
+    InternalLoader::get()->queueInGDThread(std::move(func));
 }
 
 void Loader::scheduleOnModLoad(Mod* mod, ScheduledFunction func) {
@@ -319,7 +381,8 @@ void Loader::scheduleOnModLoad(Mod* mod, ScheduledFunction func) {
     if (mod) {
         return func();
     }
-    m_scheduledFunctions.push_back(func);
+    // scheduled from static initializers, so the mod being loaded owns it
+    m_scheduledFunctions.push_back({ InternalLoader::get()->getLoadingMod(), func });
 }
 
 bool Loader::didLastLaunchCrash() const {
@@ -343,6 +406,9 @@ void Loader::updateModResources(Mod* mod) {
         return;
     }
 
+    // not getID(), which copies the ID even if tracing is off
+    utils::trace::Zone zone("Loader::updateModResources", mod->m_info.m_id);
+
     auto searchPath = this->getGeodeDirectory() / GEODE_TEMP_DIRECTORY / mod->getID() / "resources";
 
     log::debug("Adding resources for {}", mod->getID());
@@ -384,7 +450,7 @@ void Loader::updateResources() {
     this->updateModResources(InternalMod::get());
 
     // add mods' spritesheets
-    for (auto const& [_, mod] : m_mods) {
+    for (auto const& mod : m_mods) {
         this->updateModResources(mod);
     }
 }
@@ -1,6 +1,10 @@
+#include <Geode/loader/Event.hpp>
 #include <Geode/loader/Hook.hpp>
 #include <Geode/loader/Mod.hpp>
+#include <Geode/modify/Field.hpp>
+#include <Geode/modify/IDManager.hpp>
 #include <Geode/utils/file.hpp>
+#include <Geode/utils/trace.hpp>
 #include <InternalLoader.hpp>
 #include <InternalMod.hpp>
 #include <optional>
@@ -189,15 +193,31 @@ bool Mod::hasSetting(std::string const& key) const {
 
 Result<> Mod::loadBinary() {
     if (!m_binaryLoaded) {
+        utils::trace::Zone zone("Mod::loadBinary", m_info.m_id);
+
         GEODE_UNWRAP(this->createTempDir().expect("Unable to create temp directory"));
 
         if (this->hasUnresolvedDependencies()) return Err("Mod has unresolved dependencies");
 
-        GEODE_UNWRAP(this->loadPlatformBinary());
+        // Anything registered from the mod's static initializers is
+        // attributed to it through this
+        InternalLoader::get()->setLoadingMod(this);
+
+        auto platformRes = this->loadPlatformBinary();
+        if (!platformRes) {
+            InternalLoader::get()->setLoadingMod(nullptr);
+            return platformRes;
+        }
         m_binaryLoaded = true;
 
         // Call implicit entry point to place hooks etc.
         m_implicitLoadFunc(this);
+        InternalLoader::get()->setLoadingMod(nullptr);
+
+        if (m_resourcesFreed) {
+            InternalLoader::get()->loadModResources(this);
+            m_resourcesFreed = false;
+        }
 
         ModStateEvent(this, ModEventType::Loaded).post();
 
@@ -234,9 +254,35 @@ Result<> Mod::unloadBinary() {
         }
         m_patches.clear();
 
+        // Release everything else the loader handed out, while the
+        // mod's code is still mapped in
+        auto listeners = Event::removeListenersOwnedBy(this);
+        auto providers = NodeIDs::get()->removeProvidersOwnedBy(this);
+        auto fields = modifier::destroyFieldsOwnedBy(this);
+        auto spritesheets = InternalLoader::get()->freeModResources(this);
+        m_resourcesFreed = true;
+        m_resourcesQueued = false;
+        auto spriteNames = m_expandedSprites.size();
+        m_expandedSprites.clear();
+
         GEODE_UNWRAP(this->unloadPlatformBinary());
         m_binaryLoaded = false;
 
+        // Functions a mod schedules are dispatched as soon as it's
+        // loaded, so any left now point into the unloaded binary
+        auto scheduled = InternalLoader::get()->discardScheduledFunctions(this);
+
+        log::debug(
+            "Released {} event listeners, {} ID providers, {} node fields, "
+            "{} spritesheets and {} sprite names owned by {}",
+            listeners, providers, fields, spritesheets, spriteNames, m_info.m_id
+        );
+        if (scheduled) {
+            log::warn(
+                "{} left {} scheduled functions that were never run", m_info.m_id, scheduled
+            );
+        }
+
         Loader::get()->updateAllDependencies();
     }
 
@@ -295,12 +341,13 @@ Result<> Mod::uninstall() {
             "try running GD as administrator."
         );
     }
+    m_uninstalled = true;
 
     return Ok();
 }
 
 bool Mod::isUninstalled() const {
-    return this != InternalMod::get() && !ghc::filesystem::exists(m_info.m_path);
+    return m_uninstalled;
 }
 
 // Dependencies
@@ -393,6 +440,8 @@ bool Mod::depends(std::string const& id) const {
 // Hooks
 
 Result<> Mod::enableHook(Hook* hook) {
+    GEODE_TRACE_ZONE("Mod::enableHook");
+
     auto res = hook->enable();
     if (res) m_hooks.push_back(hook);
 
@@ -465,6 +514,8 @@ Result<> Mod::unpatch(Patch* patch) {
 Result<> Mod::createTempDir() {
     // Check if temp dir already exists
     if (m_tempDirName.string().empty()) {
+        utils::trace::Zone zone("Mod::createTempDir", m_info.m_id);
+
         // Create geode/temp
         auto tempDir = Loader::get()->getGeodeDirectory() / GEODE_TEMP_DIRECTORY;
         if (!file::createDirectoryAll(tempDir).isOk()) {
@@ -503,16 +554,13 @@ ghc::filesystem::path Mod::getConfigDir(bool create) const {
 }
 
 char const* Mod::expandSpriteName(char const* name) {
-    static std::unordered_map<std::string, char const*> expanded = {};
-    if (expanded.count(name)) return expanded[name];
-
-    auto exp = new char[strlen(name) + 2 + m_info.m_id.size()];
-    auto exps = m_info.m_id + "/" + name;
-    memcpy(exp, exps.c_str(), exps.size() + 1);
-
-    expanded[name] = exp;
-
-    return exp;
+    // heterogeneous lookup, so hits don't allocate
+    auto found = m_expandedSprites.find(std::string_view(name));
+    if (found != m_expandedSprites.end()) {
+        return found->second.c_str();
+    }
+    // map nodes never move, so the expanded string's buffer stays valid
+    return m_expandedSprites.emplace(name, m_info.m_id + "/" + name).first->second.c_str();
 }
 
 ModJson Mod::getRuntimeInfo() const {
@@ -1,4 +1,5 @@
 #include "../core/Core.hpp"
+#include "../index/Index.hpp"
 
 #include <Geode/loader/Loader.hpp>
 #include <Geode/loader/Log.hpp>
@@ -6,9 +7,12 @@
 #include <Geode/loader/SettingEvent.hpp>
 #include <Geode/loader/Setting.hpp>
 #include <Geode/loader/IPC.hpp>
+#include <Geode/utils/trace.hpp>
+#include <Geode/utils/web.hpp>
 #include <InternalLoader.hpp>
 #include <InternalMod.hpp>
 #include <array>
+#include <chrono>
 
 USE_GEODE_NAMESPACE();
 
@@ -102,6 +106,21 @@ BOOL WINAPI DllMain(HINSTANCE lib, DWORD reason, LPVOID) {
 
 #define $_ GEODE_CONCAT(unnamedVar_, __LINE__)
 
+// cached responses past this are evicted, least recently used first
+static constexpr size_t HTTP_CACHE_SIZE = 64 * 1024 * 1024;
+
+static void setHttpCacheEnabled(bool enabled) {
+    if (!enabled) {
+        return web::disableCache();
+    }
+    auto res = web::enableCache(
+        Loader::get()->getGeodeDirectory() / GEODE_CACHE_DIRECTORY, HTTP_CACHE_SIZE
+    );
+    if (!res) {
+        log::warn("Unable to enable HTTP cache: {}", res.unwrapErr());
+    }
+}
+
 static auto $_ = listenForSettingChanges<BoolSetting>(
     "show-platform-console",
     [](BoolSetting* setting) {
@@ -114,6 +133,27 @@ static auto $_ = listenForSettingChanges<BoolSetting>(
     }
 );
 
+static auto $_ = listenForSettingChanges<BoolSetting>(
+    "hot-reload-mods",
+    [](BoolSetting* setting) {
+        InternalLoader::get()->setHotReloadMods(setting->getValue());
+    }
+);
+
+static auto $_ = listenForSettingChanges<BoolSetting>(
+    "enable-tracing",
+    [](BoolSetting* setting) {
+        utils::trace::setEnabled(setting->getValue());
+    }
+);
+
+static auto $_ = listenForSettingChanges<BoolSetting>(
+    "http-cache",
+    [](BoolSetting* setting) {
+        setHttpCacheEnabled(setting->getValue());
+    }
+);
+
 static auto $_ = listenForIPC("ipc-test", +[](IPCEvent* event) -> nlohmann::json {
     return "Hello from Geode!";
 });
@@ -150,6 +190,186 @@ static auto $_ = listenForIPC("list-mods", +[](IPCEvent* event) -> nlohmann::jso
     return res;
 });
 
+static auto $_ = listenForIPC("trace", +[](IPCEvent* event) -> nlohmann::json {
+    auto args = event->getMessageData();
+    JsonChecker checker(args);
+    auto root = checker.root("").obj();
+
+    auto clear = root.has("clear").template get<bool>();
+
+    auto res = nlohmann::json::parse(utils::trace::dump());
+    if (clear) {
+        utils::trace::clear();
+    }
+    return res;
+});
+
+static auto $_ = listenForIPC("http-cache-stats", +[](IPCEvent* event) -> nlohmann::json {
+    auto args = event->getMessageData();
+    JsonChecker checker(args);
+    auto root = checker.root("").obj();
+
+    auto clear = root.has("clear").template get<bool>();
+
+    auto stats = web::getCacheStats();
+    if (clear) {
+        web::clearCache();
+    }
+    return {
+        { "hits", stats.m_hits },
+        { "revalidations", stats.m_revalidations },
+        { "misses", stats.m_misses },
+        { "entries", stats.m_entries },
+        { "size", stats.m_size },
+    };
+});
+
+static auto $_ = listenForIPC("index-source", +[](IPCEvent* event) -> nlohmann::json {
+    auto args = event->getMessageData();
+    JsonChecker checker(args);
+    auto root = checker.root("").obj();
+
+    auto source = Index::get()->getSource();
+    root.has("commit-url").into(source.m_commitURL);
+    root.has("snapshot-url").into(source.m_snapshotURL);
+    root.has("file-url").into(source.m_fileURL);
+    if (checker.isError()) {
+        return checker.getError();
+    }
+    Index::get()->setSource(source);
+
+    return {
+        { "commit-url", source.m_commitURL },
+        { "snapshot-url", source.m_snapshotURL },
+        { "file-url", source.m_fileURL },
+    };
+});
+
+static double millisecondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start)
+        .count();
+}
+
+// Time the index end to end: a forced update, searching, resolving the
+// dependencies of every item and installing a batch of mods. Meant to be run
+// against an index made by test/index/generate.py and served by
+// test/index/serve.py (pointed at with "index-source" first), as it installs
+// mods from it. The results are logged once everything finishes
+static auto $_ = listenForIPC("index-bench", +[](IPCEvent* event) -> nlohmann::json {
+    auto args = event->getMessageData();
+    JsonChecker checker(args);
+    auto root = checker.root("").obj();
+
+    std::vector<std::string> queries { "e", "le", "level", "texture pack", "developer 1",
+                                       "bench.mod-0001" };
+    size_t repeat = 100;
+    size_t install = 20;
+    bool cold = false;
+    bool keep = false;
+    root.has("queries").into(queries);
+    root.has("repeat").into(repeat);
+    root.has("install").into(install);
+    root.has("cold").into(cold);
+    root.has("keep").into(keep);
+    if (checker.isError()) {
+        return checker.getError();
+    }
+
+    if (cold) {
+        // without a local manifest the whole index is downloaded again
+        auto indexDir = Loader::get()->getGeodeSaveDirectory() / GEODE_INDEX_DIRECTORY;
+        std::error_code ec;
+        ghc::filesystem::remove(indexDir / "manifest.json", ec);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    Index::get()->updateIndex(
+        [=](UpdateStatus status, std::string const& info, uint8_t) {
+            if (status == UpdateStatus::Progress) return;
+            if (status == UpdateStatus::Failed) {
+                return log::warn("index-bench: updating the index failed: {}", info);
+            }
+            auto index = Index::get();
+            auto refresh = millisecondsSince(start);
+
+            auto searchStart = std::chrono::steady_clock::now();
+            size_t found = 0;
+            for (size_t i = 0; i < repeat; i++) {
+                for (auto& query : queries) {
+                    found += index->searchItems(query).size();
+                }
+            }
+            auto search = millisecondsSince(searchStart) / (repeat * queries.size());
+
+            // creating an install resolves its dependencies, and cancelling
+            // it right away keeps anything from being downloaded
+            auto dependenciesStart = std::chrono::steady_clock::now();
+            size_t resolved = 0;
+            for (auto& item : index->getItems()) {
+                if (auto handle = index->installItem(item)) {
+                    resolved += handle.unwrap()->toInstall().size();
+                    handle.unwrap()->cancel();
+                }
+            }
+            auto dependencies = millisecondsSince(dependenciesStart);
+
+            std::vector<IndexItem> items;
+            for (auto& item : index->getItems()) {
+                if (items.size() >= install) break;
+                if (!Loader::get()->isModInstalled(item.m_info.m_id)) {
+                    items.push_back(item);
+                }
+            }
+            auto installation = index->installItems(items);
+            if (!installation) {
+                return log::warn("index-bench: unable to install: {}", installation.unwrapErr());
+            }
+
+            auto installStart = std::chrono::steady_clock::now();
+            installation.unwrap()->start(
+                [=](InstallHandle handle, UpdateStatus status, std::string const& info, uint8_t) {
+                    if (status == UpdateStatus::Progress) return;
+                    if (status == UpdateStatus::Failed) {
+                        return log::warn("index-bench: installing failed: {}", info);
+                    }
+                    auto installed = millisecondsSince(installStart);
+
+                    // installed mods are loaded right away, so they have to
+                    // be uninstalled properly rather than just deleted
+                    size_t bytes = 0;
+                    for (auto& id : handle->toInstall()) {
+                        auto mod = Loader::get()->getInstalledMod(id);
+                        if (!mod) continue;
+                        std::error_code ec;
+                        bytes += static_cast<size_t>(
+                            ghc::filesystem::file_size(mod->getModInfo().m_path, ec)
+                        );
+                        if (!keep) {
+                            if (auto res = mod->uninstall(); !res) {
+                                log::warn(
+                                    "index-bench: unable to uninstall {}: {}", id,
+                                    res.unwrapErr()
+                                );
+                            }
+                        }
+                    }
+
+                    log::info(
+                        "index-bench: update {:.1f}ms ({} items), search {:.3f}ms per query "
+                        "({} results), dependencies of every item resolved in {:.1f}ms ({} "
+                        "mods), {} mods ({} KB) installed in {:.1f}ms",
+                        refresh, Index::get()->getItems().size(), search, found, dependencies,
+                        resolved, handle->toInstall().size(), bytes / 1024, installed
+                    );
+                }
+            );
+        },
+        true
+    );
+
+    return { { "started", true } };
+});
+
 int geodeEntry(void* platformData) {
     // setup internals
 
@@ -163,6 +383,15 @@ int geodeEntry(void* platformData) {
         return 1;
     }
 
+    // start tracing as early as possible so loader startup is covered
+    if (InternalMod::get()->getSettingValue<bool>("enable-tracing")) {
+        utils::trace::setEnabled(true);
+    }
+
+    if (InternalMod::get()->getSettingValue<bool>("http-cache")) {
+        setHttpCacheEnabled(true);
+    }
+
     if (!geode::core::hook::initialize()) {
         InternalLoader::platformMessageBox(
             "Unable to load Geode!",
@@ -208,6 +437,10 @@ int geodeEntry(void* platformData) {
         Loader::get()->openPlatformConsole();
     }
 
+    InternalLoader::get()->setHotReloadMods(
+        InternalMod::get()->getSettingValue<bool>("hot-reload-mods")
+    );
+
     log::debug("Entry done.");
 
     return 0;
@@ -0,0 +1,276 @@
+#include <FileWatcher.hpp>
+
+// Android is Linux too, so this backend covers both
+#ifdef __linux__
+
+    #include <Geode/loader/Loader.hpp>
+    #include <algorithm>
+    #include <cerrno>
+    #include <chrono>
+    #include <map>
+    #include <mutex>
+    #include <sys/epoll.h>
+    #include <sys/eventfd.h>
+    #include <sys/inotify.h>
+    #include <thread>
+    #include <unistd.h>
+    #include <unordered_map>
+    #include <vector>
+
+USE_GEODE_NAMESPACE();
+
+static constexpr auto const notifyAttributes = IN_CLOSE_WRITE | IN_MODIFY | IN_ATTRIB | IN_CREATE |
+    IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_DELETE_SELF;
+
+// Writes to a file usually come in bursts (a .geode being copied over
+// triggers dozens of IN_MODIFYs), so events for the same path are collapsed
+// and only delivered once the path has been quiet for this long
+static constexpr auto const debounceDelay = std::chrono::milliseconds(150);
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * All FileWatchers share one inotify instance and one thread that
+     * waits on it through epoll, no matter how many files are watched
+     */
+    class InotifyLoop {
+    public:
+        struct Watch {
+            int m_descriptor;
+            ghc::filesystem::path m_file;
+            bool m_filemode;
+            FileWatcher::FileWatchCallback m_callback;
+        };
+
+    protected:
+        struct Pending {
+            FileWatcher::FileWatchCallback m_callback;
+            Clock::time_point m_deadline;
+        };
+
+        int m_inotify = -1;
+        int m_epoll = -1;
+        int m_wakeup = -1;
+        std::thread m_thread;
+        std::mutex m_mutex;
+        std::unordered_map<FileWatcher*, Watch> m_watches;
+        // the watchers of each inotify descriptor, which can be several when
+        // they watch files in the same directory
+        std::unordered_map<int, std::vector<FileWatcher*>> m_descriptors;
+        // keyed by the watcher and the path that changed, so a burst of
+        // events for the same file only resets the deadline, and watchers
+        // that see the same path each get called
+        std::map<std::pair<FileWatcher*, std::string>, Pending> m_pending;
+
+        InotifyLoop() {
+            m_inotify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+            m_epoll = epoll_create1(EPOLL_CLOEXEC);
+            m_wakeup = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+            if (m_inotify < 0 || m_epoll < 0 || m_wakeup < 0) {
+                return;
+            }
+
+            epoll_event ev {};
+            ev.events = EPOLLIN;
+            ev.data.fd = m_inotify;
+            epoll_ctl(m_epoll, EPOLL_CTL_ADD, m_inotify, &ev);
+            ev.data.fd = m_wakeup;
+            epoll_ctl(m_epoll, EPOLL_CTL_ADD, m_wakeup, &ev);
+
+            m_thread = std::thread(&InotifyLoop::run, this);
+            m_thread.detach();
+        }
+
+        void wakeup() {
+            uint64_t one = 1;
+            (void)write(m_wakeup, &one, sizeof(one));
+        }
+
+        int nextTimeout() {
+            if (m_pending.empty()) {
+                return -1;
+            }
+            auto next = Clock::time_point::max();
+            for (auto& [_, pending] : m_pending) {
+                next = std::min(next, pending.m_deadline);
+            }
+            auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(next - Clock::now());
+            return static_cast<int>(std::max<int64_t>(ms.count(), 0));
+        }
+
+        void readEvents() {
+            alignas(inotify_event) char buffer[4096];
+            while (true) {
+                auto len = read(m_inotify, buffer, sizeof(buffer));
+                if (len <= 0) {
+                    return;
+                }
+                auto deadline = Clock::now() + debounceDelay;
+                for (char* ptr = buffer; ptr < buffer + len;) {
+                    auto event = reinterpret_cast<inotify_event*>(ptr);
+                    ptr += sizeof(inotify_event) + event->len;
+
+                    auto watchers = m_descriptors.find(event->wd);
+                    if (watchers == m_descriptors.end()) {
+                        continue;
+                    }
+                    for (auto watcher : watchers->second) {
+                        auto& watch = m_watches.at(watcher);
+                        if (!watch.m_callback) {
+                            continue;
+                        }
+                        auto changed = watch.m_file;
+                        if (event->len) {
+                            auto name = std::string(event->name);
+                            if (watch.m_filemode) {
+                                if (watch.m_file.filename().string() != name) {
+                                    continue;
+                                }
+                            }
+                            else {
+                                changed = watch.m_file / name;
+                            }
+                        }
+                        m_pending[{ watcher, changed.string() }] = { watch.m_callback, deadline };
+                    }
+                }
+            }
+        }
+
+        void dispatchExpired() {
+            auto now = Clock::now();
+            for (auto it = m_pending.begin(); it != m_pending.end();) {
+                if (it->second.m_deadline <= now) {
+                    // deliver on the GD thread so callbacks are free to touch
+                    // the loader and cocos
+                    Loader::get()->queueInGDThread(
+                        [callback = std::move(it->second.m_callback),
+                         path = ghc::filesystem::path(it->first.second)]() {
+                            callback(path);
+                        }
+                    );
+                    it = m_pending.erase(it);
+                }
+                else {
+                    ++it;
+                }
+            }
+        }
+
+        void run() {
+            epoll_event events[4];
+            while (true) {
+                int timeout;
+                {
+                    std::lock_guard lock(m_mutex);
+                    timeout = this->nextTimeout();
+                }
+                auto count = epoll_wait(m_epoll, events, 4, timeout);
+                if (count < 0 && errno != EINTR) {
+                    return;
+                }
+
+                std::lock_guard lock(m_mutex);
+                for (int i = 0; i < count; i++) {
+                    if (events[i].data.fd == m_inotify) {
+                        this->readEvents();
+                    }
+                    else {
+                        uint64_t value;
+                        (void)read(m_wakeup, &value, sizeof(value));
+                    }
+                }
+                this->dispatchExpired();
+            }
+        }
+
+    public:
+        static InotifyLoop* get() {
+            static auto inst = new InotifyLoop;
+            return inst;
+        }
+
+        int add(FileWatcher* watcher, Watch watch, ghc::filesystem::path const& target) {
+            if (m_inotify < 0) {
+                return -1;
+            }
+            std::lock_guard lock(m_mutex);
+            // inotify hands out the same descriptor for the same inode, so
+            // IN_MASK_ADD keeps watchers on a shared directory from clobbering
+            // each other's masks
+            watch.m_descriptor =
+                inotify_add_watch(m_inotify, target.string().c_str(), notifyAttributes | IN_MASK_ADD);
+            if (watch.m_descriptor < 0) {
+                return -1;
+            }
+            auto descriptor = watch.m_descriptor;
+            m_watches.insert({ watcher, std::move(watch) });
+            m_descriptors[descriptor].push_back(watcher);
+            this->wakeup();
+            return descriptor;
+        }
+
+        void remove(FileWatcher* watcher) {
+            std::lock_guard lock(m_mutex);
+            if (!m_watches.count(watcher)) {
+                return;
+            }
+            auto descriptor = m_watches.at(watcher).m_descriptor;
+            m_watches.erase(watcher);
+            auto& watchers = m_descriptors.at(descriptor);
+            watchers.erase(std::find(watchers.begin(), watchers.end(), watcher));
+            for (auto it = m_pending.begin(); it != m_pending.end();) {
+                if (it->first.first == watcher) {
+                    it = m_pending.erase(it);
+                }
+                else {
+                    ++it;
+                }
+            }
+            if (watchers.empty()) {
+                m_descriptors.erase(descriptor);
+                inotify_rm_watch(m_inotify, descriptor);
+            }
+        }
+    };
+}
+
+FileWatcher::FileWatcher(
+    ghc::filesystem::path const& file, FileWatchCallback callback, ErrorCallback error
+) {
+    this->m_filemode = ghc::filesystem::is_regular_file(file);
+
+    this->m_platform_handle = nullptr;
+    this->m_file = file;
+    this->m_callback = callback;
+    this->m_error = error;
+    this->watch();
+}
+
+FileWatcher::~FileWatcher() {
+    this->m_exiting = true;
+    InotifyLoop::get()->remove(this);
+    this->m_platform_handle = nullptr;
+}
+
+void FileWatcher::watch() {
+    // watch the parent directory in file mode, as editors and the installer
+    // replace files by renaming over them, which would orphan a watch on the
+    // file's own inode
+    auto descriptor = InotifyLoop::get()->add(
+        this, { -1, this->m_file, this->m_filemode, this->m_callback },
+        this->m_filemode ? this->m_file.parent_path() : this->m_file
+    );
+    if (descriptor < 0) {
+        if (this->m_error) this->m_error("inotify_add_watch failed");
+        return;
+    }
+    this->m_platform_handle = reinterpret_cast<void*>(static_cast<intptr_t>(descriptor) + 1);
+}
+
+bool FileWatcher::watching() const {
+    return this->m_platform_handle != nullptr;
+}
+
+#endif
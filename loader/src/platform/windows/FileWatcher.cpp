@@ -4,7 +4,9 @@
 
 #ifdef GEODE_IS_WINDOWS
 
-static constexpr auto const notifyAttributes =
+// file name changes are what report files being created, renamed and
+// deleted, which the loader relies on to know mods were uninstalled
+static constexpr auto const notifyAttributes = FILE_NOTIFY_CHANGE_FILE_NAME |
     FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_ATTRIBUTES | FILE_NOTIFY_CHANGE_SIZE;
 
 FileWatcher::FileWatcher(
@@ -35,8 +37,12 @@ FileWatcher::~FileWatcher() {
 
 void FileWatcher::watch() {
     HANDLE handle = (HANDLE)this->m_platform_handle;
-    while (WaitForSingleObject(handle, 10000) == WAIT_OBJECT_0) {
+    while (true) {
+        auto wait = WaitForSingleObject(handle, 10000);
         if (this->m_exiting) return;
+        // nothing changed for a while, which is no reason to stop watching
+        if (wait == WAIT_TIMEOUT) continue;
+        if (wait != WAIT_OBJECT_0) break;
         if (this->m_callback) {
             if (this->m_filemode) {
                 auto file = CreateFileW(
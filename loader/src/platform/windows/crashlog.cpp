@@ -4,11 +4,13 @@
 
 #ifdef GEODE_IS_WINDOWS
 
+#include <SymbolMap.hpp>
 #include <crashlog.hpp>
 
 #include <DbgHelp.h>
 #include <Geode/utils/casts.hpp>
 #include <Geode/utils/file.hpp>
+#include <Geode/utils/trace.hpp>
 #include <Windows.h>
 #include <chrono>
 #include <ctime>
@@ -133,6 +135,16 @@ static void printAddr(std::ostream& stream, void const* addr, bool fullPath = tr
                 }
 
                 stream << ")";
+                return;
+            }
+        }
+
+        // without debug symbols, functions of the game can still be named
+        // from the bindings
+        if (module == GetModuleHandle(nullptr)) {
+            auto const symbol = SymbolMap::game().describe(diff);
+            if (symbol.size()) {
+                stream << " (" << symbol << ")";
             }
         }
     }
@@ -278,6 +290,13 @@ static LONG WINAPI exceptionHandler(LPEXCEPTION_POINTERS info) {
     actualFile << file.rdbuf() << std::flush;
     actualFile.close();
 
+    // save the timeline leading up to the crash
+    if (utils::trace::isEnabled()) {
+        (void)utils::trace::saveAfterCrash(
+            crashlog::getCrashLogDirectory() + "/" + getDateString(true) + ".trace.json"
+        );
+    }
+
     return EXCEPTION_CONTINUE_SEARCH;
 }
 
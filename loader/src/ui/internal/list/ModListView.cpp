@@ -410,24 +410,50 @@ void ModListView::loadCell(TableViewCell* cell, unsigned int index) {
     }
 }
 
-bool ModListView::filter(ModInfo const& info, ModListQuery const& query) {
-    // the UI for this functionality has been removed, however
+static SearchIndex::Fields searchFields(SearchFlags flags) {
+    // the UI for choosing the flags has been removed, however
     // the code has been kept in case we want to add it back at
     // some point.
+    SearchIndex::Fields fields = 0;
+    if (flags & SearchFlag::Name) fields |= 1 << SearchIndex::Name;
+    if (flags & SearchFlag::ID) fields |= 1 << SearchIndex::ID;
+    if (flags & SearchFlag::Developer) fields |= 1 << SearchIndex::Developer;
+    if (flags & SearchFlag::Description) fields |= 1 << SearchIndex::Description;
+    if (flags & SearchFlag::Details) fields |= 1 << SearchIndex::Details;
+    return fields;
+}
 
-    if (!query.m_searchFilter) return true;
-    auto check = [query](SearchFlags flag, std::string const& name) -> bool {
-        if (!(query.m_searchFlags & flag)) return false;
-        return utils::string::contains(
-            utils::string::toLower(name), utils::string::toLower(query.m_searchFilter.value())
-        );
-    };
-    if (check(SearchFlag::Name, info.m_name)) return true;
-    if (check(SearchFlag::ID, info.m_id)) return true;
-    if (check(SearchFlag::Developer, info.m_developer)) return true;
-    if (check(SearchFlag::Description, info.m_description.value_or(""))) return true;
-    if (check(SearchFlag::Details, info.m_details.value_or(""))) return true;
-    return false;
+std::vector<Mod*> ModListView::search(std::vector<Mod*> const& mods, ModListQuery const& query) {
+    if (!query.m_searchFilter) return mods;
+
+    // there's only ever a handful of installed mods, so indexing them
+    // again for every search is cheap
+    SearchIndex index;
+    index.reserve(mods.size());
+    for (auto& mod : mods) {
+        index.add(mod->getModInfo());
+    }
+    index.finish();
+
+    std::vector<Mod*> found;
+    auto matches = index.search(query.m_searchFilter.value(), searchFields(query.m_searchFlags));
+    for (auto& match : matches) {
+        found.push_back(mods[match.m_document]);
+    }
+    return found;
+}
+
+std::vector<IndexItem const*> ModListView::search(ModListQuery const& query) {
+    if (!query.m_searchFilter) {
+        std::vector<IndexItem const*> items;
+        for (auto& item : Index::get()->getItems()) {
+            items.push_back(&item);
+        }
+        return items;
+    }
+    return Index::get()->searchItems(
+        query.m_searchFilter.value(), searchFields(query.m_searchFlags)
+    );
 }
 
 bool ModListView::filter(IndexItem const& item, ModListQuery const& query) {
@@ -449,7 +475,7 @@ bool ModListView::filter(IndexItem const& item, ModListQuery const& query) {
     }
     for (auto& plat : query.m_platforms) {
         if (item.m_download.m_platforms.count(plat)) {
-            return filter(item.m_info, query);
+            return true;
         }
     }
     return false;
@@ -477,9 +503,10 @@ static void sortInstalledMods(std::vector<Mod*>& mods) {
 }
 
 static std::vector<Mod*> sortedInstalledMods() {
-    auto mods = Loader::get()->getAllMods();
+    auto all = Loader::get()->getAllMods();
+    auto mods = std::vector<Mod*>(all.begin(), all.end());
     sortInstalledMods(mods);
-    return std::move(mods);
+    return mods;
 }
 
 bool ModListView::init(
@@ -496,19 +523,18 @@ bool ModListView::init(
                         mods->addObject(new ModObject(mod));
                     }
                     // internal geode representation always at the top
-                    auto imod = Loader::getInternalMod();
-                    if (this->filter(imod->getModInfo(), query)) {
-                        mods->addObject(new ModObject(imod));
-                    }
+                    // (unless searching, then best matches are)
+                    std::vector<Mod*> installed { Loader::getInternalMod() };
                     // then other mods
                     for (auto const& mod : sortedInstalledMods()) {
                         // if the mod is no longer installed nor
                         // loaded, it's as good as not existing
                         // (because it doesn't)
                         if (mod->isUninstalled() && !mod->isLoaded()) continue;
-                        if (this->filter(mod->getModInfo(), query)) {
-                            mods->addObject(new ModObject(mod));
-                        }
+                        installed.push_back(mod);
+                    }
+                    for (auto const& mod : this->search(installed, query)) {
+                        mods->addObject(new ModObject(mod));
                     }
                     if (!mods->count()) {
                         m_status = Status::SearchEmpty;
@@ -519,9 +545,9 @@ bool ModListView::init(
             case ModListType::Download:
                 {
                     mods = CCArray::create();
-                    for (auto const& item : Index::get()->getItems()) {
-                        if (this->filter(item, query)) {
-                            mods->addObject(new ModObject(item));
+                    for (auto const& item : this->search(query)) {
+                        if (this->filter(*item, query)) {
+                            mods->addObject(new ModObject(*item));
                         }
                     }
                     if (!mods->count()) {
@@ -533,9 +559,13 @@ bool ModListView::init(
             case ModListType::Featured:
                 {
                     mods = CCArray::create();
-                    for (auto const& item : Index::get()->getFeaturedItems()) {
-                        if (this->filter(item, query)) {
-                            mods->addObject(new ModObject(item));
+                    // featured order, unless searching, then best matches first
+                    auto items = query.m_searchFilter ? this->search(query) :
+                                                        Index::get()->getFeaturedItems();
+                    for (auto const& item : items) {
+                        if (!Index::get()->isFeaturedItem(item->m_info.m_id)) continue;
+                        if (this->filter(*item, query)) {
+                            mods->addObject(new ModObject(*item));
                         }
                     }
                     if (!mods->count()) {
@@ -125,7 +125,8 @@ protected:
         CCArray* mods, ModListType type, bool expanded, float width, float height,
         ModListQuery query
     );
-    bool filter(ModInfo const& info, ModListQuery const& query);
+    std::vector<Mod*> search(std::vector<Mod*> const& mods, ModListQuery const& query);
+    std::vector<IndexItem const*> search(ModListQuery const& query);
     bool filter(IndexItem const& item, ModListQuery const& query);
 
 public:
@@ -0,0 +1,488 @@
+#include "WebCache.hpp"
+
+#include <Geode/external/json/json.hpp>
+#include <Geode/loader/Log.hpp>
+#include <Geode/utils/file.hpp>
+#include <Geode/utils/string.hpp>
+#include <algorithm>
+#include <chrono>
+
+USE_GEODE_NAMESPACE();
+using namespace web;
+
+static constexpr auto CACHE_INDEX_FILE = "cache.json";
+// changes to the entries after which the index is written
+static constexpr size_t SAVE_BATCH = 32;
+
+static int64_t unixTime() {
+    return std::chrono::duration_cast<std::chrono::seconds>(
+               std::chrono::system_clock::now().time_since_epoch()
+    )
+        .count();
+}
+
+WebCache* WebCache::get() {
+    static auto inst = new WebCache;
+    return inst;
+}
+
+std::string WebCache::keyFor(std::string const& url, std::vector<std::string> const& headers) {
+    if (headers.empty()) {
+        return url;
+    }
+    // the order headers are added in doesn't change the response
+    auto sorted = headers;
+    std::sort(sorted.begin(), sorted.end());
+    auto key = url;
+    for (auto& header : sorted) {
+        key += "\n" + header;
+    }
+    return key;
+}
+
+std::string WebCache::fileNameFor(std::string const& key) const {
+    if (auto it = m_entries.find(key); it != m_entries.end()) {
+        return it->second.m_entry.m_file;
+    }
+    auto hash = std::hash<std::string>()(key);
+    while (true) {
+        auto name = fmt::format("{:016x}", hash);
+        if (!m_files.count(name)) {
+            return name;
+        }
+        hash += 1;
+    }
+}
+
+void WebCache::remove(std::string const& key) {
+    auto it = m_entries.find(key);
+    if (it == m_entries.end()) {
+        return;
+    }
+    auto& entry = it->second.m_entry;
+    std::error_code ec;
+    ghc::filesystem::remove(m_directory / entry.m_file, ec);
+    m_size -= entry.m_size;
+    m_files.erase(entry.m_file);
+    m_lru.erase(it->second.m_use);
+    m_entries.erase(it);
+    m_unsaved += 1;
+}
+
+void WebCache::touch(Stored& stored) {
+    stored.m_entry.m_lastUsed = ++m_useCounter;
+    m_lru.splice(m_lru.end(), m_lru, stored.m_use);
+}
+
+void WebCache::evict() {
+    while (m_size > m_maxSize && m_lru.size()) {
+        this->remove(m_lru.front());
+    }
+}
+
+void WebCache::save() {
+    auto entries = nlohmann::json::object();
+    for (auto& [key, stored] : m_entries) {
+        auto& entry = stored.m_entry;
+        entries[key] = {
+            { "file", entry.m_file },
+            { "etag", entry.m_etag },
+            { "last-modified", entry.m_lastModified },
+            { "fresh-until", entry.m_freshUntil },
+            { "last-used", entry.m_lastUsed },
+            { "size", entry.m_size },
+        };
+    }
+    (void)file::writeString(
+        m_directory / CACHE_INDEX_FILE, nlohmann::json({ { "entries", entries } }).dump()
+    );
+    m_unsaved = 0;
+}
+
+void WebCache::saveSoon() {
+    // the index holds every entry, so writing it on every change would be
+    // quadratic over a burst of requests. anything lost by not getting to
+    // write it is cleaned up by removeUnknownFiles
+    if (++m_unsaved >= SAVE_BATCH) {
+        this->save();
+    }
+}
+
+void WebCache::removeUnknownFiles() {
+    std::error_code ec;
+    for (auto& file : ghc::filesystem::directory_iterator(m_directory, ec)) {
+        auto name = file.path().filename().string();
+        if (name != CACHE_INDEX_FILE && !m_files.count(name)) {
+            ghc::filesystem::remove(file.path(), ec);
+        }
+    }
+}
+
+Result<> WebCache::add(std::string const& key, Entry entry) {
+    entry.m_lastUsed = ++m_useCounter;
+    // the new file replaced the old one, as it has the same name
+    if (auto it = m_entries.find(key); it != m_entries.end()) {
+        m_size -= it->second.m_entry.m_size;
+        m_lru.erase(it->second.m_use);
+        m_entries.erase(it);
+    }
+    m_size += entry.m_size;
+    m_files.insert(entry.m_file);
+    m_lru.push_back(key);
+    m_entries.insert({ key, Stored { std::move(entry), std::prev(m_lru.end()) } });
+    this->evict();
+    this->saveSoon();
+    return Ok();
+}
+
+Result<> WebCache::enable(ghc::filesystem::path const& directory, size_t maxSize) {
+    std::lock_guard lock(m_mutex);
+    GEODE_UNWRAP(
+        file::createDirectoryAll(directory).expect("Unable to create cache directory: {error}")
+    );
+
+    m_directory = directory;
+    m_maxSize = maxSize;
+    m_size = 0;
+    m_useCounter = 0;
+    m_entries.clear();
+    m_lru.clear();
+    m_files.clear();
+
+    if (auto data = file::readString(directory / CACHE_INDEX_FILE)) {
+        try {
+            auto json = nlohmann::json::parse(data.unwrap());
+            std::vector<std::pair<std::string, Entry>> entries;
+            for (auto& [key, value] : json.at("entries").items()) {
+                Entry entry;
+                entry.m_file = value.at("file");
+                entry.m_etag = value.at("etag");
+                entry.m_lastModified = value.at("last-modified");
+                entry.m_freshUntil = value.at("fresh-until");
+                entry.m_lastUsed = value.at("last-used");
+                entry.m_size = value.at("size");
+                // cleaned up by hand, or a write that never finished
+                if (!ghc::filesystem::exists(directory / entry.m_file)) {
+                    continue;
+                }
+                entries.emplace_back(key, std::move(entry));
+            }
+            std::sort(entries.begin(), entries.end(), [](auto const& a, auto const& b) {
+                return a.second.m_lastUsed < b.second.m_lastUsed;
+            });
+            for (auto& [key, entry] : entries) {
+                m_size += entry.m_size;
+                m_useCounter = std::max(m_useCounter, entry.m_lastUsed);
+                m_files.insert(entry.m_file);
+                m_lru.push_back(key);
+                m_entries.insert({ key, Stored { std::move(entry), std::prev(m_lru.end()) } });
+            }
+        }
+        catch (std::exception& e) {
+            log::warn("Cache index is corrupted, starting over: {}", e.what());
+            m_size = 0;
+            m_entries.clear();
+            m_lru.clear();
+            m_files.clear();
+        }
+    }
+    this->removeUnknownFiles();
+    this->evict();
+    m_unsaved = 0;
+
+    m_enabled = true;
+    return Ok();
+}
+
+void WebCache::disable() {
+    std::lock_guard lock(m_mutex);
+    if (m_enabled && m_unsaved) {
+        this->save();
+    }
+    m_enabled = false;
+}
+
+bool WebCache::isEnabled() {
+    std::lock_guard lock(m_mutex);
+    return m_enabled;
+}
+
+void WebCache::clear() {
+    std::lock_guard lock(m_mutex);
+    while (m_lru.size()) {
+        this->remove(m_lru.front());
+    }
+    if (m_enabled) {
+        this->save();
+    }
+}
+
+HttpCacheStats WebCache::getStats() {
+    std::lock_guard lock(m_mutex);
+    auto stats = m_stats;
+    stats.m_entries = m_entries.size();
+    stats.m_size = m_size;
+    return stats;
+}
+
+void WebCache::flush() {
+    std::lock_guard lock(m_mutex);
+    if (m_enabled && m_unsaved) {
+        this->save();
+    }
+}
+
+std::optional<WebCache::Entry> WebCache::lookup(std::string const& key) {
+    std::lock_guard lock(m_mutex);
+    if (!m_enabled || !m_entries.count(key)) {
+        return std::nullopt;
+    }
+    return m_entries.at(key).m_entry;
+}
+
+Result<byte_array> WebCache::readBytes(
+    std::string const& key, bool revalidated, int64_t freshUntil
+) {
+    std::lock_guard lock(m_mutex);
+    if (!m_entries.count(key)) {
+        return Err("Response is not cached");
+    }
+    auto& stored = m_entries.at(key);
+    auto data = file::readBinary(m_directory / stored.m_entry.m_file);
+    if (!data) {
+        this->remove(key);
+        return Err(data.unwrapErr());
+    }
+    this->touch(stored);
+    if (revalidated) {
+        stored.m_entry.m_freshUntil = freshUntil;
+        m_stats.m_revalidations += 1;
+        this->saveSoon();
+    }
+    else {
+        m_stats.m_hits += 1;
+    }
+    return data;
+}
+
+Result<> WebCache::copyTo(
+    std::string const& key, ghc::filesystem::path const& path, bool revalidated,
+    int64_t freshUntil
+) {
+    std::lock_guard lock(m_mutex);
+    if (!m_entries.count(key)) {
+        return Err("Response is not cached");
+    }
+    auto& stored = m_entries.at(key);
+    std::error_code ec;
+    ghc::filesystem::copy_file(
+        m_directory / stored.m_entry.m_file, path,
+        ghc::filesystem::copy_options::overwrite_existing, ec
+    );
+    if (ec) {
+        this->remove(key);
+        return Err("Unable to copy cached file: " + ec.message());
+    }
+    this->touch(stored);
+    if (revalidated) {
+        stored.m_entry.m_freshUntil = freshUntil;
+        m_stats.m_revalidations += 1;
+        this->saveSoon();
+    }
+    else {
+        m_stats.m_hits += 1;
+    }
+    return Ok();
+}
+
+Result<> WebCache::store(std::string const& key, Entry entry, byte_array const& data) {
+    std::lock_guard lock(m_mutex);
+    m_stats.m_misses += 1;
+    if (!m_enabled || data.size() > m_maxSize) {
+        return Ok();
+    }
+    entry.m_file = this->fileNameFor(key);
+    entry.m_size = data.size();
+    GEODE_UNWRAP(file::writeBinary(m_directory / entry.m_file, data));
+    return this->add(key, std::move(entry));
+}
+
+Result<> WebCache::store(
+    std::string const& key, Entry entry, ghc::filesystem::path const& path
+) {
+    std::lock_guard lock(m_mutex);
+    m_stats.m_misses += 1;
+    std::error_code ec;
+    auto size = ghc::filesystem::file_size(path, ec);
+    if (!m_enabled || ec || size > m_maxSize) {
+        return Ok();
+    }
+    entry.m_file = this->fileNameFor(key);
+    entry.m_size = size;
+    ghc::filesystem::copy_file(
+        path, m_directory / entry.m_file, ghc::filesystem::copy_options::overwrite_existing, ec
+    );
+    if (ec) {
+        return Err("Unable to copy file into cache: " + ec.message());
+    }
+    return this->add(key, std::move(entry));
+}
+
+void WebCache::countMiss() {
+    std::lock_guard lock(m_mutex);
+    m_stats.m_misses += 1;
+}
+
+CachedRequest::CachedRequest(std::string const& url, std::vector<std::string> const& headers) :
+    m_url(url), m_key(WebCache::keyFor(url, headers)),
+    m_cached(WebCache::get()->lookup(m_key)) {}
+
+bool CachedRequest::isFresh() const {
+    return m_cached && unixTime() < m_cached.value().m_freshUntil;
+}
+
+bool CachedRequest::notModified() const {
+    return m_cached && m_status == 304;
+}
+
+size_t CachedRequest::onHeader(char* data, size_t size, size_t nmemb, void* self) {
+    static_cast<CachedRequest*>(self)->parseHeader(std::string_view(data, size * nmemb));
+    return size * nmemb;
+}
+
+void CachedRequest::parseHeader(std::string_view line) {
+    // redirects send a whole new set of headers
+    if (line.substr(0, 5) == "HTTP/") {
+        m_status = 0;
+        m_etag.clear();
+        m_lastModified.clear();
+        m_maxAge = std::nullopt;
+        m_noCache = false;
+        m_noStore = false;
+        auto space = line.find(' ');
+        if (space != std::string_view::npos) {
+            m_status = std::strtol(std::string(line.substr(space + 1, 3)).c_str(), nullptr, 10);
+        }
+        return;
+    }
+    auto colon = line.find(':');
+    if (colon == std::string_view::npos) {
+        return;
+    }
+    auto name = string::toLower(std::string(line.substr(0, colon)));
+    auto value = std::string(line.substr(colon + 1));
+    string::trimIP(value);
+
+    if (name == "etag") {
+        m_etag = value;
+    }
+    else if (name == "last-modified") {
+        m_lastModified = value;
+    }
+    else if (name == "cache-control") {
+        for (auto directive : string::split(string::toLower(value), ",")) {
+            string::trimIP(directive);
+            if (directive == "no-store") {
+                m_noStore = true;
+            }
+            else if (directive == "no-cache") {
+                m_noCache = true;
+            }
+            else if (directive.rfind("max-age=", 0) == 0) {
+                m_maxAge = std::strtoll(directive.c_str() + 8, nullptr, 10);
+            }
+        }
+    }
+}
+
+int64_t CachedRequest::freshUntil() const {
+    if (m_noCache || !m_maxAge) {
+        return 0;
+    }
+    return unixTime() + m_maxAge.value();
+}
+
+WebCache::Entry CachedRequest::makeEntry() const {
+    WebCache::Entry entry;
+    entry.m_etag = m_etag;
+    entry.m_lastModified = m_lastModified;
+    entry.m_freshUntil = this->freshUntil();
+    return entry;
+}
+
+curl_slist* CachedRequest::prepare(CURL* curl, curl_slist* headers) {
+    // a 304 to validators the caller sent isn't about the cached copy
+    for (auto header = headers; header && m_cached; header = header->next) {
+        auto name = string::toLower(std::string(header->data).substr(0, 18));
+        if (name.rfind("if-none-match:", 0) == 0 || name.rfind("if-modified-since:", 0) == 0) {
+            m_cached = std::nullopt;
+        }
+    }
+    if (m_cached) {
+        if (m_cached.value().m_etag.size()) {
+            headers = curl_slist_append(
+                headers, ("If-None-Match: " + m_cached.value().m_etag).c_str()
+            );
+        }
+        if (m_cached.value().m_lastModified.size()) {
+            headers = curl_slist_append(
+                headers, ("If-Modified-Since: " + m_cached.value().m_lastModified).c_str()
+            );
+        }
+    }
+    curl_easy_setopt(curl, CURLOPT_HEADERFUNCTION, &CachedRequest::onHeader);
+    curl_easy_setopt(curl, CURLOPT_HEADERDATA, this);
+    return headers;
+}
+
+Result<byte_array> CachedRequest::readBytes() {
+    auto res = WebCache::get()->readBytes(m_key, this->notModified(), this->freshUntil());
+    if (!res) {
+        m_cached = std::nullopt;
+    }
+    return res;
+}
+
+Result<> CachedRequest::copyTo(ghc::filesystem::path const& path) {
+    auto res = WebCache::get()->copyTo(m_key, path, this->notModified(), this->freshUntil());
+    if (!res) {
+        m_cached = std::nullopt;
+    }
+    return res;
+}
+
+void CachedRequest::store(byte_array const& data) {
+    if (m_status != 200 || m_noStore ||
+        (m_etag.empty() && m_lastModified.empty() && !this->freshUntil())) {
+        return WebCache::get()->countMiss();
+    }
+    if (auto res = WebCache::get()->store(m_key, this->makeEntry(), data); !res) {
+        log::warn("Unable to cache {}: {}", m_url, res.unwrapErr());
+    }
+}
+
+void CachedRequest::store(ghc::filesystem::path const& path) {
+    if (m_status != 200 || m_noStore ||
+        (m_etag.empty() && m_lastModified.empty() && !this->freshUntil())) {
+        return WebCache::get()->countMiss();
+    }
+    if (auto res = WebCache::get()->store(m_key, this->makeEntry(), path); !res) {
+        log::warn("Unable to cache {}: {}", m_url, res.unwrapErr());
+    }
+}
+
+Result<> web::enableCache(ghc::filesystem::path const& directory, size_t maxSize) {
+    return WebCache::get()->enable(directory, maxSize);
+}
+
+void web::disableCache() {
+    WebCache::get()->disable();
+}
+
+void web::clearCache() {
+    WebCache::get()->clear();
+}
+
+HttpCacheStats web::getCacheStats() {
+    return WebCache::get()->getStats();
+}
@@ -0,0 +1,160 @@
+#pragma once
+
+#include <Geode/cocos/platform/IncludeCurl.h>
+#include <Geode/utils/web.hpp>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace geode::utils::web {
+    /**
+     * On-disk HTTP cache shared by every web request. Responses are kept
+     * with their validators and evicted least recently used first once the
+     * cache grows past its size limit. Does nothing until enabled through
+     * web::enableCache. Entries are keyed by the URL and the headers sent
+     * with it, see keyFor
+     */
+    class WebCache final {
+    public:
+        struct Entry {
+            std::string m_file;
+            std::string m_etag;
+            std::string m_lastModified;
+            // unix time until which the entry may be used without asking
+            // the server if it's still valid
+            int64_t m_freshUntil = 0;
+            // position in the order of use, for evicting the least recently
+            // used entries first
+            uint64_t m_lastUsed = 0;
+            size_t m_size = 0;
+        };
+
+    protected:
+        struct Stored {
+            Entry m_entry;
+            // position in m_lru
+            std::list<std::string>::iterator m_use;
+        };
+
+        std::mutex m_mutex;
+        bool m_enabled = false;
+        ghc::filesystem::path m_directory;
+        size_t m_maxSize = 0;
+        size_t m_size = 0;
+        uint64_t m_useCounter = 0;
+        std::unordered_map<std::string, Stored> m_entries;
+        // keys of the entries, least recently used first
+        std::list<std::string> m_lru;
+        // names of the files of the entries
+        std::unordered_set<std::string> m_files;
+        // changes to the entries that haven't been written to the index
+        size_t m_unsaved = 0;
+        HttpCacheStats m_stats;
+
+        std::string fileNameFor(std::string const& key) const;
+        void remove(std::string const& key);
+        void touch(Stored& stored);
+        void evict();
+        void save();
+        void saveSoon();
+        void removeUnknownFiles();
+        Result<> add(std::string const& key, Entry entry);
+
+    public:
+        static WebCache* get();
+
+        /**
+         * Key of the cache entry of a request. Responses may vary with any
+         * of the headers sent, so they're part of it
+         */
+        static std::string keyFor(std::string const& url, std::vector<std::string> const& headers);
+
+        Result<> enable(ghc::filesystem::path const& directory, size_t maxSize);
+        void disable();
+        bool isEnabled();
+        void clear();
+        HttpCacheStats getStats();
+        /**
+         * Write the index if any entries changed since it was last written.
+         * It's only written every so many changes otherwise
+         */
+        void flush();
+
+        std::optional<Entry> lookup(std::string const& key);
+        Result<byte_array> readBytes(std::string const& key, bool revalidated, int64_t freshUntil);
+        Result<> copyTo(
+            std::string const& key, ghc::filesystem::path const& path, bool revalidated,
+            int64_t freshUntil
+        );
+        Result<> store(std::string const& key, Entry entry, byte_array const& data);
+        Result<> store(std::string const& key, Entry entry, ghc::filesystem::path const& path);
+        void countMiss();
+    };
+
+    /**
+     * Cache state of a single GET request: sends the validators of the
+     * cached copy along with the request, and records the caching headers
+     * of the response so it can be stored or served from the cache
+     */
+    class CachedRequest final {
+    protected:
+        std::string m_url;
+        std::string m_key;
+        std::optional<WebCache::Entry> m_cached;
+        long m_status = 0;
+        std::string m_etag;
+        std::string m_lastModified;
+        std::optional<int64_t> m_maxAge;
+        bool m_noCache = false;
+        bool m_noStore = false;
+
+        static size_t onHeader(char* data, size_t size, size_t nmemb, void* self);
+        void parseHeader(std::string_view line);
+        int64_t freshUntil() const;
+        WebCache::Entry makeEntry() const;
+
+    public:
+        CachedRequest(std::string const& url, std::vector<std::string> const& headers = {});
+
+        /**
+         * Whether the cached copy can be used without asking the server
+         */
+        bool isFresh() const;
+        /**
+         * Whether the server answered with 304 Not Modified to the
+         * validators sent by prepare()
+         */
+        bool notModified() const;
+
+        /**
+         * Add the validators of the cached copy to the request headers and
+         * start listening to the response headers. If the headers already
+         * have validators of their own, the cached copy isn't used
+         * @returns The new header list
+         */
+        curl_slist* prepare(CURL* curl, curl_slist* headers = nullptr);
+
+        /**
+         * Read the cached copy, after isFresh() or notModified(). If it has
+         * been evicted in the meantime, the request has to be sent again
+         * and prepare() will no longer add validators
+         */
+        Result<byte_array> readBytes();
+        /**
+         * Copy the cached copy into a file, after isFresh() or notModified().
+         * Fails the same way as readBytes()
+         */
+        Result<> copyTo(ghc::filesystem::path const& path);
+
+        /**
+         * Store a freshly downloaded response, if its headers allow that
+         */
+        void store(byte_array const& data);
+        /**
+         * Store a freshly downloaded file, if its headers allow that
+         */
+        void store(ghc::filesystem::path const& path);
+    };
+}
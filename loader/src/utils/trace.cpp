@@ -0,0 +1,203 @@
+#include <Geode/external/json/json.hpp>
+#include <Geode/utils/file.hpp>
+#include <Geode/utils/trace.hpp>
+#include <array>
+#include <atomic>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <unordered_set>
+#include <vector>
+
+USE_GEODE_NAMESPACE();
+
+// zones per thread before the oldest ones start getting overwritten
+static constexpr size_t TRACE_BUFFER_SIZE = 8192;
+
+namespace {
+    struct TraceEvent {
+        char const* m_name;
+        int64_t m_start;
+        int64_t m_duration;
+    };
+
+    // Other threads read the slot while its owner may be overwriting it, so
+    // it's stamped with the index of the event in it: 0 while being written,
+    // and readers only take what they read if the stamp was the index they
+    // wanted both before and after reading
+    struct TraceSlot {
+        std::atomic<size_t> m_stamp = 0;
+        std::atomic<char const*> m_name = nullptr;
+        std::atomic<int64_t> m_start = 0;
+        std::atomic<int64_t> m_duration = 0;
+    };
+
+    // Only ever written by the thread that owns it, so recording a zone
+    // doesn't need any locks. Buffers are never freed so they can still be
+    // dumped after their thread exits, or from a crash handler
+    struct ThreadBuffer {
+        uint32_t m_threadIndex;
+        // only ever goes up, clear() moves the epoch instead of resetting it
+        std::atomic<size_t> m_written = 0;
+        std::array<TraceSlot, TRACE_BUFFER_SIZE> m_slots;
+    };
+
+    struct TraceState {
+        std::atomic_bool m_enabled = false;
+        // zones that started before this were cleared
+        std::atomic<int64_t> m_epoch = utils::trace::now();
+        std::mutex m_mutex;
+        std::vector<ThreadBuffer*> m_buffers;
+        std::unordered_set<std::string> m_names;
+
+        static TraceState& get() {
+            static auto inst = new TraceState;
+            return *inst;
+        }
+    };
+}
+
+static ThreadBuffer* threadBuffer() {
+    thread_local ThreadBuffer* buffer = nullptr;
+    if (!buffer) {
+        auto& state = TraceState::get();
+        std::lock_guard lock(state.m_mutex);
+        buffer = new ThreadBuffer;
+        buffer->m_threadIndex = static_cast<uint32_t>(state.m_buffers.size() + 1);
+        state.m_buffers.push_back(buffer);
+    }
+    return buffer;
+}
+
+bool utils::trace::isEnabled() {
+    return TraceState::get().m_enabled.load(std::memory_order_relaxed);
+}
+
+void utils::trace::setEnabled(bool enabled) {
+    TraceState::get().m_enabled = enabled;
+}
+
+void utils::trace::clear() {
+    // the buffers belong to their threads, so rather than emptying them
+    // everything recorded so far is skipped when dumping
+    TraceState::get().m_epoch = utils::trace::now();
+}
+
+char const* utils::trace::intern(std::string_view name) {
+    auto& state = TraceState::get();
+    std::lock_guard lock(state.m_mutex);
+    // node-based set, so the pointers stay valid as it grows
+    return state.m_names.emplace(name).first->c_str();
+}
+
+void utils::trace::record(char const* name, int64_t start, int64_t duration) {
+    auto buffer = threadBuffer();
+    auto index = buffer->m_written.load(std::memory_order_relaxed);
+    auto& slot = buffer->m_slots[index % TRACE_BUFFER_SIZE];
+    slot.m_stamp.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.m_name.store(name, std::memory_order_relaxed);
+    slot.m_start.store(start, std::memory_order_relaxed);
+    slot.m_duration.store(duration, std::memory_order_relaxed);
+    slot.m_stamp.store(index + 1, std::memory_order_release);
+    buffer->m_written.store(index + 1, std::memory_order_release);
+}
+
+// call the callback with every event recorded since the last clear() that
+// wasn't overwritten while reading it. the caller has to hold the lock
+template <class F>
+static void forEachEvent(TraceState& state, F&& callback) {
+    auto epoch = state.m_epoch.load();
+    for (auto& buffer : state.m_buffers) {
+        auto written = buffer->m_written.load(std::memory_order_acquire);
+        auto count = std::min(written, TRACE_BUFFER_SIZE);
+        for (auto i = written - count; i < written; i++) {
+            auto& slot = buffer->m_slots[i % TRACE_BUFFER_SIZE];
+            if (slot.m_stamp.load(std::memory_order_acquire) != i + 1) {
+                continue;
+            }
+            TraceEvent event {
+                slot.m_name.load(std::memory_order_relaxed),
+                slot.m_start.load(std::memory_order_relaxed),
+                slot.m_duration.load(std::memory_order_relaxed),
+            };
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.m_stamp.load(std::memory_order_relaxed) != i + 1) {
+                continue;
+            }
+            if (event.m_start < epoch) {
+                continue;
+            }
+            callback(*buffer, event, epoch);
+        }
+    }
+}
+
+std::string utils::trace::dump() {
+    auto& state = TraceState::get();
+    auto events = nlohmann::json::array();
+
+    std::lock_guard lock(state.m_mutex);
+    forEachEvent(state, [&](ThreadBuffer& buffer, TraceEvent const& event, int64_t epoch) {
+        events.push_back({
+            { "name", event.m_name },
+            { "cat", "geode" },
+            { "ph", "X" },
+            { "ts", (event.m_start - epoch) / 1000.0 },
+            { "dur", event.m_duration / 1000.0 },
+            { "pid", 1 },
+            { "tid", buffer.m_threadIndex },
+        });
+    });
+
+    return nlohmann::json({
+        { "traceEvents", events },
+        { "displayTimeUnit", "ms" },
+    }).dump();
+}
+
+Result<> utils::trace::save(ghc::filesystem::path const& path) {
+    return file::writeString(path, utils::trace::dump());
+}
+
+bool utils::trace::saveAfterCrash(ghc::filesystem::path const& path) {
+    auto& state = TraceState::get();
+    // the crashed thread may be the one holding the lock
+    std::unique_lock lock(state.m_mutex, std::try_to_lock);
+    if (!lock.owns_lock()) {
+        return false;
+    }
+    auto file = std::fopen(path.string().c_str(), "wb");
+    if (!file) {
+        return false;
+    }
+
+    // events are formatted into this one at a time instead of building the
+    // whole document, so the heap isn't touched while writing
+    static char line[1024];
+    std::fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[", file);
+    auto first = true;
+    forEachEvent(state, [&](ThreadBuffer& buffer, TraceEvent const& event, int64_t epoch) {
+        // names are escaped by dropping whatever would need escaping
+        char name[256];
+        size_t length = 0;
+        for (auto c = event.m_name; *c && length < sizeof(name) - 1; c++) {
+            if (*c != '"' && *c != '\\' && static_cast<unsigned char>(*c) >= 0x20) {
+                name[length++] = *c;
+            }
+        }
+        name[length] = 0;
+        std::snprintf(
+            line, sizeof(line),
+            "%s{\"name\":\"%s\",\"cat\":\"geode\",\"ph\":\"X\",\"ts\":%.3f,"
+            "\"dur\":%.3f,\"pid\":1,\"tid\":%u}",
+            first ? "" : ",", name, (event.m_start - epoch) / 1000.0,
+            event.m_duration / 1000.0, buffer.m_threadIndex
+        );
+        std::fputs(line, file);
+        first = false;
+    });
+    std::fputs("]}", file);
+    std::fclose(file);
+    return true;
+}
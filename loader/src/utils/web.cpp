@@ -1,23 +1,35 @@
+#include "WebCache.hpp"
+
 #include <Geode/cocos/platform/IncludeCurl.h>
 #include <Geode/loader/Loader.hpp>
 #include <Geode/utils/casts.hpp>
+#include <Geode/utils/string.hpp>
+#include <Geode/utils/trace.hpp>
 #include <Geode/utils/web.hpp>
+#include <array>
+#include <condition_variable>
+#include <deque>
 #include <thread>
 
 USE_GEODE_NAMESPACE();
 using namespace web;
 
+// Transfers past these limits wait in a queue. Requests to the same host
+// get multiplexed over one connection on HTTP/2 anyway
+static constexpr size_t MAX_TRANSFERS = 24;
+static constexpr size_t MAX_TRANSFERS_PER_HOST = 6;
+// idle connections kept open for reuse
+static constexpr long MAX_CACHED_CONNECTIONS = 16;
+// how long the networking thread waits at a time on curls too old to be
+// woken up
+static constexpr long MAX_WAIT_MS = 50;
+
 namespace geode::utils::fetch {
     static size_t writeBytes(char* data, size_t size, size_t nmemb, void* str) {
         as<byte_array*>(str)->insert(as<byte_array*>(str)->end(), data, data + size * nmemb);
         return size * nmemb;
     }
 
-    static size_t writeString(char* data, size_t size, size_t nmemb, void* str) {
-        as<std::string*>(str)->append(data, size * nmemb);
-        return size * nmemb;
-    }
-
     static size_t writeBinaryData(char* data, size_t size, size_t nmemb, void* file) {
         as<std::ostream*>(file)->write(data, size * nmemb);
         return size * nmemb;
@@ -28,9 +40,49 @@ namespace geode::utils::fetch {
     }
 }
 
+static std::array<std::mutex, CURL_LOCK_DATA_LAST> SHARE_LOCKS;
+
+static CURLSH* sharedCaches() {
+    static auto share = [] {
+        auto share = curl_share_init();
+        curl_share_setopt(
+            share, CURLSHOPT_LOCKFUNC,
+            +[](CURL*, curl_lock_data data, curl_lock_access, void*) {
+                SHARE_LOCKS[data].lock();
+            }
+        );
+        curl_share_setopt(share, CURLSHOPT_UNLOCKFUNC, +[](CURL*, curl_lock_data data, void*) {
+            SHARE_LOCKS[data].unlock();
+        });
+        curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+        curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+        // curls older than 7.57 refuse this and keep a pool per handle
+        curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_CONNECT);
+        return share;
+    }();
+    return share;
+}
+
+/**
+ * Share DNS results, TLS sessions and connections between every request,
+ * sync or async, so repeated requests to the same host skip the handshake
+ */
+static void useSharedCaches(CURL* curl) {
+    curl_easy_setopt(curl, CURLOPT_SHARE, sharedCaches());
+#if LIBCURL_VERSION_NUM >= 0x072F00
+    // falls back to HTTP/1.1 if either end doesn't support 2
+    curl_easy_setopt(curl, CURLOPT_HTTP_VERSION, CURL_HTTP_VERSION_2TLS);
+#endif
+}
+
 Result<> web::fetchFile(
     std::string const& url, ghc::filesystem::path const& into, FileProgressCallback prog
 ) {
+    CachedRequest cache(url);
+    if (cache.isFresh() && cache.copyTo(into)) {
+        return Ok();
+    }
+
     auto curl = curl_easy_init();
 
     if (!curl) return Err("Curl not initialized!");
@@ -48,12 +100,34 @@ Result<> web::fetchFile(
     curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, utils::fetch::writeBinaryData);
     curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1);
     curl_easy_setopt(curl, CURLOPT_USERAGENT, "github_api/1.0");
+    useSharedCaches(curl);
     if (prog) {
         curl_easy_setopt(curl, CURLOPT_NOPROGRESS, 0);
         curl_easy_setopt(curl, CURLOPT_PROGRESSFUNCTION, utils::fetch::progress);
         curl_easy_setopt(curl, CURLOPT_PROGRESSDATA, &prog);
     }
+    auto headers = cache.prepare(curl);
+    curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
     auto res = curl_easy_perform(curl);
+    curl_slist_free_all(headers);
+
+    if (res == CURLE_OK && cache.notModified()) {
+        file.close();
+        if (cache.copyTo(into)) {
+            curl_easy_cleanup(curl);
+            return Ok();
+        }
+        // evicted since it was looked up, so ask for the whole response
+        file.open(into, std::ios::out | std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            curl_easy_cleanup(curl);
+            return Err("Unable to open output file");
+        }
+        headers = cache.prepare(curl);
+        curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
+        res = curl_easy_perform(curl);
+        curl_slist_free_all(headers);
+    }
     if (res != CURLE_OK) {
         curl_easy_cleanup(curl);
         return Err("Fetch failed: " + std::string(curl_easy_strerror(res)));
@@ -63,6 +137,8 @@ Result<> web::fetchFile(
     res = curl_easy_getinfo(curl, CURLINFO_CONTENT_TYPE, &ct);
     if ((res == CURLE_OK) && ct) {
         curl_easy_cleanup(curl);
+        file.close();
+        cache.store(into);
         return Ok();
     }
     curl_easy_cleanup(curl);
@@ -70,6 +146,13 @@ Result<> web::fetchFile(
 }
 
 Result<byte_array> web::fetchBytes(std::string const& url) {
+    CachedRequest cache(url);
+    if (cache.isFresh()) {
+        if (auto data = cache.readBytes()) {
+            return data;
+        }
+    }
+
     auto curl = curl_easy_init();
 
     if (!curl) return Err("Curl not initialized!");
@@ -81,7 +164,24 @@ Result<byte_array> web::fetchBytes(std::string const& url) {
     curl_easy_setopt(curl, CURLOPT_WRITEDATA, &ret);
     curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, utils::fetch::writeBytes);
     curl_easy_setopt(curl, CURLOPT_USERAGENT, "github_api/1.0");
+    useSharedCaches(curl);
+    auto headers = cache.prepare(curl);
+    curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
     auto res = curl_easy_perform(curl);
+    curl_slist_free_all(headers);
+
+    if (res == CURLE_OK && cache.notModified()) {
+        if (auto data = cache.readBytes()) {
+            curl_easy_cleanup(curl);
+            return data;
+        }
+        // evicted since it was looked up, so ask for the whole response
+        ret.clear();
+        headers = cache.prepare(curl);
+        curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
+        res = curl_easy_perform(curl);
+        curl_slist_free_all(headers);
+    }
     if (res != CURLE_OK) {
         curl_easy_cleanup(curl);
         return Err("Fetch failed");
@@ -91,6 +191,7 @@ Result<byte_array> web::fetchBytes(std::string const& url) {
     res = curl_easy_getinfo(curl, CURLINFO_CONTENT_TYPE, &ct);
     if ((res == CURLE_OK) && ct) {
         curl_easy_cleanup(curl);
+        cache.store(ret);
         return Ok(ret);
     }
     curl_easy_cleanup(curl);
@@ -98,147 +199,498 @@ Result<byte_array> web::fetchBytes(std::string const& url) {
 }
 
 Result<std::string> web::fetch(std::string const& url) {
-    auto curl = curl_easy_init();
-
-    if (!curl) return Err("Curl not initialized!");
-
-    std::string ret;
-    curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
-    curl_easy_setopt(curl, CURLOPT_SSL_VERIFYPEER, 0);
-    curl_easy_setopt(curl, CURLOPT_SSL_VERIFYHOST, 0);
-    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &ret);
-    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, utils::fetch::writeString);
-    curl_easy_setopt(curl, CURLOPT_USERAGENT, "github_api/1.0");
-    auto res = curl_easy_perform(curl);
-    if (res != CURLE_OK) {
-        curl_easy_cleanup(curl);
-        return Err("Fetch failed");
-    }
-
-    char* ct;
-    res = curl_easy_getinfo(curl, CURLINFO_CONTENT_TYPE, &ct);
-    if ((res == CURLE_OK) && ct) {
-        curl_easy_cleanup(curl);
-        return Ok(ret);
-    }
-    curl_easy_cleanup(curl);
-    return Err("Error getting info: " + std::string(curl_easy_strerror(res)));
+    GEODE_UNWRAP_INTO(auto data, web::fetchBytes(url));
+    return Ok(std::string(data.begin(), data.end()));
 }
 
 static std::unordered_map<std::string, SentAsyncWebRequestHandle> RUNNING_REQUESTS {};
 static std::mutex RUNNING_REQUESTS_MUTEX;
 
-SentAsyncWebRequest::SentAsyncWebRequest(AsyncWebRequest const& req, std::string const& id) :
-    m_id(id), m_url(req.m_url), m_target(req.m_target), m_httpHeaders(req.m_httpHeaders) {
-#define AWAIT_RESUME()    \
-    while (m_paused) {}   \
-    if (m_cancelled) {    \
-        this->doCancel(); \
-        return;           \
+// a finished request may already have been replaced by a newer one that was
+// sent with the same join ID
+static void removeRunningRequest(std::string const& id, SentAsyncWebRequest const* req) {
+    std::lock_guard _(RUNNING_REQUESTS_MUTEX);
+    auto it = RUNNING_REQUESTS.find(id);
+    if (it != RUNNING_REQUESTS.end() && it->second.get() == req) {
+        RUNNING_REQUESTS.erase(it);
     }
+}
 
-    if (req.m_then) m_thens.push_back(req.m_then);
-    if (req.m_progress) m_progresses.push_back(req.m_progress);
-    if (req.m_cancelled) m_cancelleds.push_back(req.m_cancelled);
-    if (req.m_expect) m_expects.push_back(req.m_expect);
+namespace geode::utils::web {
+    /**
+     * Drives every async request from a single networking thread through one
+     * curl multi handle, instead of a thread per request. Requests past the
+     * concurrency limits wait in a queue until a slot frees up
+     */
+    class WebLoop {
+    protected:
+        struct Transfer {
+            SentAsyncWebRequestHandle m_request;
+            std::string m_host;
+            CURL* m_curl = nullptr;
+            curl_slist* m_headers = nullptr;
+            byte_array m_data;
+            std::unique_ptr<std::ofstream> m_file = nullptr;
+            std::optional<CachedRequest> m_cache;
+            bool m_paused = false;
+            double m_lastNow = -1.0;
+            double m_lastTotal = -1.0;
+        };
+
+        CURLM* m_multi = nullptr;
+        std::thread m_thread;
+        std::mutex m_mutex;
+        std::condition_variable m_condition;
+        bool m_woken = false;
+        std::vector<SentAsyncWebRequestHandle> m_incoming;
+        // only ever touched from the networking thread
+        std::deque<std::unique_ptr<Transfer>> m_queued;
+        std::vector<std::unique_ptr<Transfer>> m_active;
+        std::unordered_map<std::string, size_t> m_hostTransfers;
+
+        WebLoop() {
+            m_multi = curl_multi_init();
+#ifdef CURLPIPE_MULTIPLEX
+            curl_multi_setopt(m_multi, CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX);
+#endif
+            curl_multi_setopt(m_multi, CURLMOPT_MAXCONNECTS, MAX_CACHED_CONNECTIONS);
+
+            m_thread = std::thread(&WebLoop::run, this);
+            m_thread.detach();
+        }
 
-    std::thread([this]() {
-        AWAIT_RESUME();
+        static std::string hostOf(std::string const& url) {
+            auto start = url.find("://");
+            start = start == std::string::npos ? 0 : start + 3;
+            auto end = url.find_first_of("/?#", start);
+            return url.substr(start, end == std::string::npos ? end : end - start);
+        }
 
-        auto curl = curl_easy_init();
-        if (!curl) {
-            return this->error("Curl not initialized");
+        static bool isCacheable(SentAsyncWebRequest const& req) {
+            // streamed bodies are never fully in our hands
+            if (std::holds_alternative<std::ostream*>(req.m_target) ||
+                std::holds_alternative<AsyncStream>(req.m_target)) {
+                return false;
+            }
+            // partial bodies can't be cached
+            if (req.m_resumeFrom) {
+                return false;
+            }
+            // the request does its own revalidation
+            for (auto& header : req.m_httpHeaders) {
+                if (string::toLower(header.substr(0, 3)) == "if-") {
+                    return false;
+                }
+            }
+            return true;
         }
 
-        // resulting byte array
-        byte_array ret;
-        // output file if downloading to file. unique_ptr because not always
-        // initialized but don't wanna manually managed memory
-        std::unique_ptr<std::ofstream> file = nullptr;
-
-        // into file
-        if (std::holds_alternative<ghc::filesystem::path>(m_target)) {
-            file = std::make_unique<std::ofstream>(
-                std::get<ghc::filesystem::path>(m_target), std::ios::out | std::ios::binary
-            );
-            curl_easy_setopt(curl, CURLOPT_WRITEDATA, file.get());
-            curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, utils::fetch::writeBinaryData);
+        static Result<> serveCached(Transfer& transfer) {
+            auto& target = transfer.m_request->m_target;
+            if (std::holds_alternative<ghc::filesystem::path>(target)) {
+                return transfer.m_cache->copyTo(std::get<ghc::filesystem::path>(target));
+            }
+            GEODE_UNWRAP_INTO(transfer.m_data, transfer.m_cache->readBytes());
+            return Ok();
         }
-        // into stream
-        else if (std::holds_alternative<std::ostream*>(m_target)) {
-            curl_easy_setopt(curl, CURLOPT_WRITEDATA, std::get<std::ostream*>(m_target));
-            curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, utils::fetch::writeBinaryData);
+
+        static size_t writeStream(char* data, size_t size, size_t nmemb, void* ptr) {
+            auto req = static_cast<Transfer*>(ptr)->m_request;
+            auto& stream = std::get<AsyncStream>(req->m_target);
+            if (!stream(reinterpret_cast<uint8_t const*>(data), size * nmemb)) {
+                req->m_cancelled = true;
+                return 0;
+            }
+            return size * nmemb;
         }
-        // into memory
-        else {
-            curl_easy_setopt(curl, CURLOPT_WRITEDATA, &ret);
-            curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, utils::fetch::writeBytes);
+
+        static int progress(void* ptr, double total, double now, double, double) {
+            auto transfer = static_cast<Transfer*>(ptr);
+            auto req = transfer->m_request;
+            if (req->m_cancelled) {
+                return 1;
+            }
+            // curl calls this many times a second even when nothing changed
+            if (now == transfer->m_lastNow && total == transfer->m_lastTotal) {
+                return 0;
+            }
+            transfer->m_lastNow = now;
+            transfer->m_lastTotal = total;
+            Loader::get()->queueInGDThread([req, now, total]() {
+                std::lock_guard _(req->m_mutex);
+                for (auto& prog : req->m_progresses) {
+                    prog(*req, now, total);
+                }
+            });
+            return 0;
         }
-        curl_easy_setopt(curl, CURLOPT_URL, m_url.c_str());
-        curl_easy_setopt(curl, CURLOPT_SSL_VERIFYPEER, 0);
-        curl_easy_setopt(curl, CURLOPT_SSL_VERIFYHOST, 0);
-        curl_easy_setopt(curl, CURLOPT_USERAGENT, "github_api/1.0");
-        curl_easy_setopt(curl, CURLOPT_NOPROGRESS, 0);
-        curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1);
 
-        curl_slist* headers = nullptr;
-        for (auto& header : m_httpHeaders) {
-            headers = curl_slist_append(headers, header.c_str());
+        Result<> start(Transfer& transfer) {
+            auto req = transfer.m_request;
+            auto curl = curl_easy_init();
+            if (!curl) {
+                return Err("Curl not initialized");
+            }
+            transfer.m_curl = curl;
+
+            // into file
+            if (std::holds_alternative<ghc::filesystem::path>(req->m_target)) {
+                auto mode = std::ios::out | std::ios::binary;
+                if (req->m_resumeFrom) {
+                    mode |= std::ios::app;
+                }
+                transfer.m_file = std::make_unique<std::ofstream>(
+                    std::get<ghc::filesystem::path>(req->m_target), mode
+                );
+                if (!transfer.m_file->is_open()) {
+                    return Err("Unable to open output file");
+                }
+                curl_easy_setopt(curl, CURLOPT_WRITEDATA, transfer.m_file.get());
+                curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, utils::fetch::writeBinaryData);
+            }
+            // into stream
+            else if (std::holds_alternative<std::ostream*>(req->m_target)) {
+                curl_easy_setopt(curl, CURLOPT_WRITEDATA, std::get<std::ostream*>(req->m_target));
+                curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, utils::fetch::writeBinaryData);
+            }
+            // into a chunk handler
+            else if (std::holds_alternative<AsyncStream>(req->m_target)) {
+                curl_easy_setopt(curl, CURLOPT_WRITEDATA, &transfer);
+                curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, &WebLoop::writeStream);
+            }
+            // into memory
+            else {
+                curl_easy_setopt(curl, CURLOPT_WRITEDATA, &transfer.m_data);
+                curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, utils::fetch::writeBytes);
+            }
+            curl_easy_setopt(curl, CURLOPT_URL, req->m_url.c_str());
+            curl_easy_setopt(curl, CURLOPT_SSL_VERIFYPEER, 0);
+            curl_easy_setopt(curl, CURLOPT_SSL_VERIFYHOST, 0);
+            curl_easy_setopt(curl, CURLOPT_USERAGENT, "github_api/1.0");
+            curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1);
+            // don't hand error pages over as if they were the requested data
+            if (req->m_failOnError) {
+                curl_easy_setopt(curl, CURLOPT_FAILONERROR, 1L);
+            }
+            if (req->m_resumeFrom) {
+                // curl fails the transfer if the server ignores the range
+                curl_easy_setopt(
+                    curl, CURLOPT_RESUME_FROM_LARGE, static_cast<curl_off_t>(req->m_resumeFrom)
+                );
+            }
+            curl_easy_setopt(curl, CURLOPT_NOPROGRESS, 0);
+            curl_easy_setopt(curl, CURLOPT_PROGRESSFUNCTION, &WebLoop::progress);
+            curl_easy_setopt(curl, CURLOPT_PROGRESSDATA, &transfer);
+            useSharedCaches(curl);
+#if LIBCURL_VERSION_NUM >= 0x072B00
+            // wait for an existing HTTP/2 connection to the same host rather
+            // than opening a new one
+            curl_easy_setopt(curl, CURLOPT_PIPEWAIT, 1L);
+#endif
+
+            for (auto& header : req->m_httpHeaders) {
+                transfer.m_headers = curl_slist_append(transfer.m_headers, header.c_str());
+            }
+            if (transfer.m_cache) {
+                transfer.m_headers = transfer.m_cache->prepare(curl, transfer.m_headers);
+            }
+            curl_easy_setopt(curl, CURLOPT_HTTPHEADER, transfer.m_headers);
+
+            if (curl_multi_add_handle(m_multi, curl) != CURLM_OK) {
+                return Err("Unable to start transfer");
+            }
+            return Ok();
+        }
+
+        void release(Transfer& transfer) {
+            if (transfer.m_curl) {
+                curl_multi_remove_handle(m_multi, transfer.m_curl);
+                curl_easy_cleanup(transfer.m_curl);
+                transfer.m_curl = nullptr;
+            }
+            curl_slist_free_all(transfer.m_headers);
+            transfer.m_headers = nullptr;
+            // close before doCancel tries to remove it
+            if (transfer.m_file) {
+                transfer.m_file->close();
+            }
+        }
+
+        void finish(std::unique_ptr<Transfer> transfer, CURLcode code) {
+            long status = 0;
+            curl_easy_getinfo(transfer->m_curl, CURLINFO_RESPONSE_CODE, &status);
+            this->release(*transfer);
+            if (--m_hostTransfers.at(transfer->m_host) == 0) {
+                m_hostTransfers.erase(transfer->m_host);
+            }
+
+            Result<> result = Ok();
+            if (code == CURLE_HTTP_RETURNED_ERROR) {
+                result = Err("Fetch failed: HTTP error " + std::to_string(status));
+            }
+            else if (code != CURLE_OK) {
+                result = Err("Fetch failed: " + std::string(curl_easy_strerror(code)));
+            }
+            else if (transfer->m_cache && transfer->m_cache->notModified()) {
+                result = this->serveCached(*transfer);
+                // evicted since it was looked up, so send the request again
+                // without validators to get the whole response
+                if (!result) {
+                    transfer->m_data.clear();
+                    transfer->m_file = nullptr;
+                    m_queued.push_front(std::move(transfer));
+                    // this may have been the last active transfer, in which
+                    // case nothing else would get to start it
+                    return this->startQueued();
+                }
+            }
+            else if (transfer->m_cache) {
+                auto& target = transfer->m_request->m_target;
+                if (std::holds_alternative<ghc::filesystem::path>(target)) {
+                    transfer->m_cache->store(std::get<ghc::filesystem::path>(target));
+                }
+                else {
+                    transfer->m_cache->store(transfer->m_data);
+                }
+            }
+            this->complete(std::move(transfer), result);
         }
-        curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
 
-        struct ProgressData {
-            SentAsyncWebRequest* self;
-            std::ofstream* file;
-        } data { this, file.get() };
-
-        curl_easy_setopt(
-            curl, CURLOPT_PROGRESSFUNCTION,
-            +[](void* ptr, double total, double now, double, double) -> int {
-                auto data = static_cast<ProgressData*>(ptr);
-                while (data->self->m_paused) {}
-                if (data->self->m_cancelled) {
-                    if (data->file) {
-                        data->file->close();
+        void complete(std::unique_ptr<Transfer> transfer, Result<> const& result) {
+            auto req = transfer->m_request;
+            // set before checking for cancellation, so a cancel() racing with
+            // this either gets seen here or sees the request as finished
+            if (result) {
+                req->m_finished = true;
+            }
+            if (req->m_cancelled) {
+                return req->doCancel();
+            }
+            if (!result) {
+                return req->error(result.unwrapErr());
+            }
+
+            // convert here so parsing a large response doesn't stall a frame,
+            // and only hand the converted values over to the GD thread
+            std::vector<AsyncDeliver> deliveries;
+            {
+                GEODE_TRACE_ZONE("web::convert");
+                std::lock_guard _(req->m_mutex);
+                for (auto& then : req->m_thens) {
+                    if (auto deliver = then(*req, transfer->m_data)) {
+                        deliveries.push_back(std::move(deliver));
                     }
-                    return 1;
                 }
-                Loader::get()->queueInGDThread([self = data->self, now, total]() {
-                    std::lock_guard _(self->m_mutex);
-                    for (auto& prog : self->m_progresses) {
-                        prog(*self, now, total);
+            }
+            Loader::get()->queueInGDThread([req, deliveries = std::move(deliveries)]() {
+                for (auto& deliver : deliveries) {
+                    deliver(*req);
+                }
+                removeRunningRequest(req->m_id, req.get());
+            });
+        }
+
+        void applyRequestStates() {
+            for (auto it = m_active.begin(); it != m_active.end();) {
+                auto& transfer = **it;
+                if (transfer.m_request->m_cancelled) {
+                    auto owned = std::move(*it);
+                    it = m_active.erase(it);
+                    this->finish(std::move(owned), CURLE_ABORTED_BY_CALLBACK);
+                    continue;
+                }
+                bool paused = transfer.m_request->m_paused;
+                if (paused != transfer.m_paused) {
+                    curl_easy_pause(transfer.m_curl, paused ? CURLPAUSE_ALL : CURLPAUSE_CONT);
+                    transfer.m_paused = paused;
+                }
+                ++it;
+            }
+            for (auto it = m_queued.begin(); it != m_queued.end();) {
+                if ((*it)->m_request->m_cancelled) {
+                    (*it)->m_request->doCancel();
+                    it = m_queued.erase(it);
+                }
+                else {
+                    ++it;
+                }
+            }
+        }
+
+        bool canStart(Transfer const& transfer) {
+            return !transfer.m_request->m_paused &&
+                m_hostTransfers[transfer.m_host] < MAX_TRANSFERS_PER_HOST;
+        }
+
+        // whether startQueued() would start anything
+        bool hasStartable() {
+            if (m_active.size() >= MAX_TRANSFERS) {
+                return false;
+            }
+            for (auto& transfer : m_queued) {
+                if (this->canStart(*transfer)) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        void startQueued() {
+            for (auto it = m_queued.begin();
+                 it != m_queued.end() && m_active.size() < MAX_TRANSFERS;) {
+                if (!this->canStart(**it)) {
+                    ++it;
+                    continue;
+                }
+                auto transfer = std::move(*it);
+                it = m_queued.erase(it);
+                if (transfer->m_cache && transfer->m_cache->isFresh() &&
+                    this->serveCached(*transfer)) {
+                    this->complete(std::move(transfer), Ok());
+                    continue;
+                }
+                if (auto res = this->start(*transfer); !res) {
+                    this->release(*transfer);
+                    transfer->m_request->error(res.unwrapErr());
+                    continue;
+                }
+                m_hostTransfers[transfer->m_host] += 1;
+                m_active.push_back(std::move(transfer));
+            }
+        }
+
+        void readCompleted() {
+            int left;
+            while (auto msg = curl_multi_info_read(m_multi, &left)) {
+                if (msg->msg != CURLMSG_DONE) {
+                    continue;
+                }
+                // the message is invalidated once the handle is removed
+                auto curl = msg->easy_handle;
+                auto result = msg->data.result;
+                for (auto it = m_active.begin(); it != m_active.end(); ++it) {
+                    if ((*it)->m_curl == curl) {
+                        auto transfer = std::move(*it);
+                        m_active.erase(it);
+                        this->finish(std::move(transfer), result);
+                        break;
                     }
+                }
+            }
+        }
+
+        void waitForActivity() {
+#if LIBCURL_VERSION_NUM >= 0x074400
+            curl_multi_poll(m_multi, nullptr, 0, 1000, nullptr);
+#else
+            // older curls can't be woken up from a wait, so only wait for
+            // short slices at a time to notice new requests
+            long timeout = -1;
+            curl_multi_timeout(m_multi, &timeout);
+            if (timeout < 0 || timeout > MAX_WAIT_MS) {
+                timeout = MAX_WAIT_MS;
+            }
+            fd_set read, write, except;
+            FD_ZERO(&read);
+            FD_ZERO(&write);
+            FD_ZERO(&except);
+            int maxfd = -1;
+            curl_multi_fdset(m_multi, &read, &write, &except, &maxfd);
+            if (maxfd < 0) {
+                std::unique_lock lock(m_mutex);
+                m_condition.wait_for(lock, std::chrono::milliseconds(timeout), [this] {
+                    return m_woken;
                 });
-                return 0;
             }
-        );
-        curl_easy_setopt(curl, CURLOPT_PROGRESSDATA, &data);
-        auto res = curl_easy_perform(curl);
-        if (res != CURLE_OK) {
-            return this->error("Fetch failed: " + std::string(curl_easy_strerror(res)));
+            else {
+                timeval tv { timeout / 1000, (timeout % 1000) * 1000 };
+                select(maxfd + 1, &read, &write, &except, &tv);
+            }
+#endif
         }
-        curl_easy_cleanup(curl);
 
-        AWAIT_RESUME();
+        void run() {
+            while (true) {
+                std::vector<SentAsyncWebRequestHandle> incoming;
+                {
+                    std::unique_lock lock(m_mutex);
+                    // with nothing in flight or waiting to start, sleep until
+                    // a request is sent, resumed or cancelled
+                    m_condition.wait(lock, [this] {
+                        return m_woken || !m_active.empty() || this->hasStartable();
+                    });
+                    m_woken = false;
+                    incoming.swap(m_incoming);
+                }
+                for (auto& req : incoming) {
+                    auto transfer = std::make_unique<Transfer>();
+                    transfer->m_host = hostOf(req->m_url);
+                    if (isCacheable(*req)) {
+                        transfer->m_cache.emplace(req->m_url, req->m_httpHeaders);
+                    }
+                    transfer->m_request = std::move(req);
+                    m_queued.push_back(std::move(transfer));
+                }
 
-        // if something is still holding a handle to this
-        // request, then they may still cancel it
-        m_finished = true;
+                this->applyRequestStates();
+                this->startQueued();
+                if (m_active.empty()) {
+                    // write the entries cached by the requests that just
+                    // finished while there's nothing else to do
+                    WebCache::get()->flush();
+                    continue;
+                }
 
-        Loader::get()->queueInGDThread([this, ret]() {
-            std::lock_guard _(m_mutex);
-            for (auto& then : m_thens) {
-                then(*this, ret);
+                int running;
+                curl_multi_perform(m_multi, &running);
+                this->readCompleted();
+                // finished transfers free up slots for the queued ones, which
+                // nothing else would start if none are left active
+                this->startQueued();
+                if (!m_active.empty()) {
+                    this->waitForActivity();
+                }
             }
-            std::lock_guard __(RUNNING_REQUESTS_MUTEX);
-            RUNNING_REQUESTS.erase(m_id);
-        });
-    }).detach();
+        }
+
+    public:
+        static WebLoop* get() {
+            static auto inst = new WebLoop;
+            return inst;
+        }
+
+        void add(SentAsyncWebRequestHandle const& req) {
+            {
+                std::lock_guard lock(m_mutex);
+                m_incoming.push_back(req);
+            }
+            this->wake();
+        }
+
+        void wake() {
+            {
+                std::lock_guard lock(m_mutex);
+                m_woken = true;
+            }
+            m_condition.notify_one();
+#if LIBCURL_VERSION_NUM >= 0x074400
+            curl_multi_wakeup(m_multi);
+#endif
+        }
+    };
+}
+
+SentAsyncWebRequest::SentAsyncWebRequest(AsyncWebRequest const& req, std::string const& id) :
+    m_id(id), m_url(req.m_url), m_target(req.m_target), m_httpHeaders(req.m_httpHeaders),
+    m_resumeFrom(req.m_resumeFrom), m_failOnError(req.m_failOnError) {
+    if (req.m_then) m_thens.push_back(req.m_then);
+    if (req.m_progress) m_progresses.push_back(req.m_progress);
+    if (req.m_cancelled) m_cancelleds.push_back(req.m_cancelled);
+    if (req.m_expect) m_expects.push_back(req.m_expect);
 }
 
 void SentAsyncWebRequest::doCancel() {
-    if (m_cleanedUp) return;
-    m_cleanedUp = true;
+    if (m_cleanedUp.exchange(true)) return;
 
     // remove file if downloaded to one
     if (std::holds_alternative<ghc::filesystem::path>(m_target)) {
@@ -252,10 +704,12 @@ void SentAsyncWebRequest::doCancel() {
         }
     }
 
-    Loader::get()->queueInGDThread([this]() {
-        std::lock_guard _(m_mutex);
-        for (auto& canc : m_cancelleds) {
-            canc(*this);
+    // the queue may run after the request was replaced in the running
+    // requests by another one with the same ID, so it keeps itself alive
+    Loader::get()->queueInGDThread([self = shared_from_this()]() {
+        std::lock_guard _(self->m_mutex);
+        for (auto& canc : self->m_cancelleds) {
+            canc(*self);
         }
     });
 
@@ -268,14 +722,19 @@ void SentAsyncWebRequest::cancel() {
     if (m_finished) {
         this->doCancel();
     }
+    else {
+        WebLoop::get()->wake();
+    }
 }
 
 void SentAsyncWebRequest::pause() {
     m_paused = true;
+    WebLoop::get()->wake();
 }
 
 void SentAsyncWebRequest::resume() {
     m_paused = false;
+    WebLoop::get()->wake();
 }
 
 bool SentAsyncWebRequest::finished() const {
@@ -283,14 +742,14 @@ bool SentAsyncWebRequest::finished() const {
 }
 
 void SentAsyncWebRequest::error(std::string const& error) {
-    while (m_paused) {};
-    Loader::get()->queueInGDThread([this, error]() {
-        std::lock_guard _(m_mutex);
-        for (auto& expect : m_expects) {
-            expect(error);
+    Loader::get()->queueInGDThread([self = shared_from_this(), error]() {
+        {
+            std::lock_guard _(self->m_mutex);
+            for (auto& expect : self->m_expects) {
+                expect(error);
+            }
         }
-        std::lock_guard __(RUNNING_REQUESTS_MUTEX);
-        RUNNING_REQUESTS.erase(m_id);
+        removeRunningRequest(self->m_id, self.get());
     });
 }
 
@@ -304,6 +763,16 @@ AsyncWebRequest& AsyncWebRequest::header(std::string const& header) {
     return *this;
 }
 
+AsyncWebRequest& AsyncWebRequest::failOnError(bool fail) {
+    m_failOnError = fail;
+    return *this;
+}
+
+AsyncWebRequest& AsyncWebRequest::resumeFrom(size_t offset) {
+    m_resumeFrom = offset;
+    return *this;
+}
+
 AsyncWebResponse AsyncWebRequest::fetch(std::string const& url) {
     m_url = url;
     return AsyncWebResponse(*this);
@@ -330,15 +799,12 @@ SentAsyncWebRequestHandle AsyncWebRequest::send() {
 
     std::lock_guard __(RUNNING_REQUESTS_MUTEX);
 
-    // pause all running requests
-    for (auto& [_, req] : RUNNING_REQUESTS) {
-        req->pause();
-    }
-
     SentAsyncWebRequestHandle ret;
 
     static size_t COUNTER = 0;
-    if (m_joinID && RUNNING_REQUESTS.count(m_joinID.value())) {
+    // joining a request that's already finished would never get the result
+    if (m_joinID && RUNNING_REQUESTS.count(m_joinID.value()) &&
+        !RUNNING_REQUESTS.at(m_joinID.value())->m_finished) {
         auto& req = RUNNING_REQUESTS.at(m_joinID.value());
         std::lock_guard _(req->m_mutex);
         if (m_then) req->m_thens.push_back(m_then);
@@ -350,12 +816,8 @@ SentAsyncWebRequestHandle AsyncWebRequest::send() {
     else {
         auto id = m_joinID.value_or("__anon_request_" + std::to_string(COUNTER++));
         ret = std::make_shared<SentAsyncWebRequest>(*this, id);
-        RUNNING_REQUESTS.insert({ id, ret });
-    }
-
-    // resume all running requests
-    for (auto& [_, req] : RUNNING_REQUESTS) {
-        req->resume();
+        RUNNING_REQUESTS.insert_or_assign(id, ret);
+        WebLoop::get()->add(ret);
     }
 
     return ret;
@@ -379,6 +841,13 @@ AsyncWebResult<std::monostate> AsyncWebResponse::into(ghc::filesystem::path cons
     });
 }
 
+AsyncWebResult<std::monostate> AsyncWebResponse::stream(AsyncStream handler) {
+    m_request.m_target = std::move(handler);
+    return this->as(+[](byte_array const&) -> Result<std::monostate> {
+        return Ok(std::monostate());
+    });
+}
+
 AsyncWebResult<std::string> AsyncWebResponse::text() {
     return this->as(+[](byte_array const& bytes) -> Result<std::string> {
         return Ok(std::string(bytes.begin(), bytes.end()));
@@ -0,0 +1,75 @@
+#!/usr/bin/env python3
+"""
+Times building the sample mods in this folder against the SDK, with the
+precompiled header built per mod or shared between them, and with the full
+Geode/Modify.hpp or only the per-class modify headers:
+
+    python bench.py --mods 4 --sources 8
+
+GEODE_SDK has to point at the SDK with the loader prebuilts installed.
+Codegen and the libraries the SDK builds are built before timing, so only
+compiling the mods (and their precompiled headers) is measured
+"""
+
+import argparse
+import os
+import shutil
+import subprocess
+import time
+
+VARIANTS = {
+    "pch per mod": [],
+    "shared pch": ["-DGEODE_SHARED_PCH=ON"],
+    "pch per mod, per-class includes": ["-DBENCH_PER_CLASS_INCLUDES=ON"],
+    "shared pch, per-class includes": ["-DGEODE_SHARED_PCH=ON", "-DBENCH_PER_CLASS_INCLUDES=ON"],
+}
+
+
+def run(args):
+    subprocess.run(args, check=True, stdout=subprocess.DEVNULL)
+
+
+def bench(build, flags, args):
+    if os.path.exists(build):
+        shutil.rmtree(build)
+    configure = [
+        "cmake", "-S", os.path.dirname(os.path.abspath(__file__)), "-B", build,
+        f"-DBENCH_MODS={args.mods}", f"-DBENCH_SOURCES={args.sources}",
+        "-DGEODE_DISABLE_CLI_CALLS=ON", f"-DCMAKE_BUILD_TYPE={args.config}", *flags,
+    ]
+    if args.generator:
+        configure += ["-G", args.generator]
+    run(configure)
+
+    build_args = ["cmake", "--build", build, "--config", args.config, "--parallel", str(args.jobs)]
+    run(build_args + ["--target", "CodegenRun", "fmt", "filesystem"])
+    start = time.perf_counter()
+    run(build_args + ["--target", "bench-mods"])
+    return time.perf_counter() - start
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(description=__doc__.strip().splitlines()[0])
+    parser.add_argument("--mods", type=int, default=4, help="number of mods")
+    parser.add_argument("--sources", type=int, default=8, help="source files per mod")
+    parser.add_argument("--jobs", type=int, default=os.cpu_count(), help="parallel compile jobs")
+    parser.add_argument("--config", default="RelWithDebInfo")
+    parser.add_argument("--generator", help="CMake generator to use")
+    parser.add_argument("--build", default="build-bench", help="where to build (replaced)")
+    parser.add_argument("--variant", choices=VARIANTS, action="append", help="only run these")
+    args = parser.parse_args()
+
+    if "GEODE_SDK" not in os.environ:
+        parser.error("GEODE_SDK is not set")
+
+    results = {}
+    for name in args.variant or VARIANTS:
+        seconds = bench(os.path.abspath(args.build), VARIANTS[name], args)
+        results[name] = seconds
+        print(f"{name:>34}: {seconds:8.2f}s")
+
+    if len(results) > 1:
+        baseline = next(iter(results.values()))
+        print()
+        for name, seconds in results.items():
+            print(f"{name:>34}: {baseline / seconds:5.2f}x")
@@ -1,7 +1,218 @@
 #include <Geode/Loader.hpp>
+#include <Geode/loader/IPC.hpp>
+#include <Geode/utils/web.hpp>
+
+#ifdef GEODE_IS_WINDOWS
+    #include <Windows.h>
+    #include <Psapi.h>
+#elif defined(GEODE_IS_MACOS)
+    #include <mach/mach.h>
+#else
+    #include <fstream>
+    #include <unistd.h>
+#endif
 
 USE_GEODE_NAMESPACE();
 
+static size_t residentMemory() {
+#ifdef GEODE_IS_WINDOWS
+    PROCESS_MEMORY_COUNTERS_EX counters;
+    GetProcessMemoryInfo(
+        GetCurrentProcess(), reinterpret_cast<PROCESS_MEMORY_COUNTERS*>(&counters), sizeof(counters)
+    );
+    return counters.PrivateUsage;
+#elif defined(GEODE_IS_MACOS)
+    mach_task_basic_info info;
+    mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+    task_info(mach_task_self(), MACH_TASK_BASIC_INFO, reinterpret_cast<task_info_t>(&info), &count);
+    return info.resident_size;
+#else
+    // the second field is the number of resident pages
+    std::ifstream statm("/proc/self/statm");
+    size_t size = 0;
+    size_t resident = 0;
+    if (!(statm >> size >> resident)) {
+        return 0;
+    }
+    return resident * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+#endif
+}
+
+// Whether geode.test has its resources added exactly once, as they should
+// be while it's loaded. Loading queues adding them to the GD thread, so this
+// is only meaningful once the queue has run
+static bool hasResourcesOnce(Mod* mod) {
+    auto searchPath = (
+        Loader::get()->getGeodeDirectory() / GEODE_TEMP_DIRECTORY / mod->getID() / "resources"
+    ).string();
+    size_t count = 0;
+    for (auto path : CCFileUtils::get()->getSearchPaths()) {
+        std::string str = path;
+        if (str.ends_with("/")) str.pop_back();
+        if (str.ends_with(searchPath)) count += 1;
+    }
+    if (count != 1) {
+        log::error("unload-stress: resource search path added {} times", count);
+        return false;
+    }
+    for (auto const& sheet : mod->getModInfo().m_spritesheets) {
+        if (!CCTextureCache::get()->textureForKey((sheet + ".png").c_str())) {
+            log::error("unload-stress: spritesheet {} is not loaded", sheet);
+            return false;
+        }
+    }
+    return true;
+}
+
+struct UnloadStress {
+    Mod* mod;
+    int iterations;
+    // cycles run so far, counting the warm-up ones
+    int done = 0;
+    size_t before = 0;
+};
+
+// warm up caches & allocator pools so they don't count as growth
+static constexpr int UNLOAD_WARMUP = 10;
+
+static void finishUnloadStress(UnloadStress const& state, bool passed, std::string const& error) {
+    auto after = residentMemory();
+    auto growth = after > state.before ? after - state.before : 0;
+    auto cycles = std::max(state.done - UNLOAD_WARMUP, 1);
+    // without a way to measure memory the leak check can't pass
+    if (!after && passed) {
+        return log::warn(
+            "unload-stress: unloaded geode.test {} times, but memory usage couldn't be "
+            "measured on this platform (skipped{})",
+            cycles, error
+        );
+    }
+    // anything leaked per reload would add up to far more than this
+    passed = passed && growth / cycles < 256;
+    log::info(
+        "unload-stress: unloaded geode.test {} times, memory went from {} to {} bytes ({}{})",
+        cycles, state.before, after, passed ? "passed" : "failed", error
+    );
+}
+
+static void stepUnloadStress(std::shared_ptr<UnloadStress> state) {
+    auto mod = state->mod;
+    // the previous cycle's resource load has run by now
+    if (!hasResourcesOnce(mod)) {
+        return finishUnloadStress(*state, false, "");
+    }
+    if (state->done == UNLOAD_WARMUP) {
+        state->before = residentMemory();
+    }
+    if (state->done == state->iterations + UNLOAD_WARMUP) {
+        return finishUnloadStress(*state, true, "");
+    }
+    // every other cycle reloads twice before the queued load gets to run
+    auto reloads = state->done % 2 ? 2 : 1;
+    for (int i = 0; i < reloads; i++) {
+        if (auto res = mod->unloadBinary(); !res) {
+            return finishUnloadStress(*state, false, ", unable to unload: " + res.unwrapErr());
+        }
+        if (auto res = mod->loadBinary(); !res) {
+            return finishUnloadStress(*state, false, ", unable to load: " + res.unwrapErr());
+        }
+    }
+    state->done += 1;
+    Loader::get()->queueInGDThread([state]() {
+        stepUnloadStress(state);
+    });
+}
+
+// Unload & load the main test mod over and over and check that memory usage
+// stays flat, and that its resources end up added once and only once. One
+// cycle is run per frame so the resource loads queued to the GD thread run
+// in between. Run by sending `unload-stress` to `geode.testdep` over IPC;
+// the results are logged once it's done
+static auto _ = listenForIPC("unload-stress", +[](IPCEvent* event) -> nlohmann::json {
+    auto mod = Loader::get()->getLoadedMod("geode.test");
+    if (!mod) {
+        return { { "error", "geode.test is not loaded" } };
+    }
+
+    auto state = std::make_shared<UnloadStress>();
+    state->mod = mod;
+    state->iterations = event->getMessageData().value("iterations", 1000);
+    Loader::get()->queueInGDThread([state]() {
+        stepUnloadStress(state);
+    });
+
+    return { { "iterations", state->iterations } };
+});
+
+// Send a burst of async requests at once and check that every one of them
+// completes. Point it at a local server (`python -m http.server` will do) so
+// the result doesn't depend on the network. Run by sending `web-stress` to
+// `geode.testdep` over IPC; the results are logged once everything finishes
+static auto webStress = listenForIPC("web-stress", +[](IPCEvent* event) -> nlohmann::json {
+    auto url = event->getMessageData().value("url", "http://localhost:8000/");
+    auto count = event->getMessageData().value("count", 200);
+
+    struct Results {
+        int succeeded = 0;
+        int failed = 0;
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    };
+    auto results = std::make_shared<Results>();
+    auto check = [results, count]() {
+        if (results->succeeded + results->failed < count) {
+            return;
+        }
+        auto time = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - results->start
+        );
+        log::info(
+            "web-stress: {} of {} requests succeeded in {}ms ({})", results->succeeded, count,
+            time.count(), results->failed ? "failed" : "passed"
+        );
+    };
+
+    for (int i = 0; i < count; i++) {
+        web::AsyncWebRequest()
+            .expect([results, check](std::string const& error) {
+                log::warn("web-stress: {}", error);
+                results->failed += 1;
+                check();
+            })
+            .fetch(url)
+            .bytes()
+            .then([results, check](byte_array const&) {
+                results->succeeded += 1;
+                check();
+            });
+    }
+
+    return { { "sent", count } };
+});
+
+// Fetch the same URL twice and check that the second time is answered from
+// the HTTP cache. Needs the loader's http-cache setting on and a server that
+// sends validators, which `python -m http.server` does. Run by sending
+// `web-cache` to `geode.testdep` over IPC
+static auto webCache = listenForIPC("web-cache", +[](IPCEvent* event) -> nlohmann::json {
+    auto url = event->getMessageData().value("url", "http://localhost:8000/");
+
+    if (auto res = web::fetchBytes(url); !res) {
+        return { { "error", res.unwrapErr() } };
+    }
+    auto before = web::getCacheStats();
+    if (auto res = web::fetchBytes(url); !res) {
+        return { { "error", res.unwrapErr() } };
+    }
+    auto after = web::getCacheStats();
+
+    auto cached = after.m_hits + after.m_revalidations - before.m_hits - before.m_revalidations;
+    return {
+        { "hits", after.m_hits - before.m_hits },
+        { "revalidations", after.m_revalidations - before.m_revalidations },
+        { "passed", cached == 1 },
+    };
+});
+
 #include <Geode/modify/MenuLayer.hpp>
 
 struct MyMenuLayer : Modify<MyMenuLayer, MenuLayer> {
@@ -0,0 +1,117 @@
+#!/usr/bin/env python3
+"""
+Generates a synthetic mods index, along with the .geode packages it points
+to, for benchmarking index updates and installs against serve.py:
+
+    python generate.py /tmp/index --count 1000
+    python serve.py /tmp/index
+
+Every mod gets a mod.json, an index.json, an about.md and a package under
+packages/. Mods depend on a few of the mods generated before them, so
+installing one pulls in a chain of dependencies. The same seed always
+produces the same index
+"""
+
+import argparse
+import hashlib
+import io
+import json
+import os
+import random
+import shutil
+import zipfile
+
+WORDS = (
+    "level editor texture pack speed hack practice music menu icon kit "
+    "shader particle trail color object layer trigger camera zoom noclip "
+    "fps bypass button layout font label popup profile search filter "
+    "online save backup replay macro audio sync copy paste group"
+).split()
+
+CATEGORIES = ["gameplay", "editor", "offline", "online", "universal", "enhancement"]
+PLATFORMS = ["windows", "macos", "android", "ios"]
+
+
+def sentence(rng, length):
+    return " ".join(rng.choice(WORDS) for _ in range(length)).capitalize()
+
+
+def package(info, size, rng):
+    buffer = io.BytesIO()
+    with zipfile.ZipFile(buffer, "w", zipfile.ZIP_DEFLATED) as zip:
+        zip.writestr("mod.json", json.dumps(info, indent=4))
+        # random bytes so compression doesn't make every package tiny
+        zip.writestr("resources/data.bin", rng.randbytes(size), zipfile.ZIP_STORED)
+    return buffer.getvalue()
+
+
+def generate(root, count, deps, size, url, geode, seed):
+    rng = random.Random(seed)
+    if os.path.exists(root):
+        shutil.rmtree(root)
+    os.makedirs(os.path.join(root, "index"))
+    os.makedirs(os.path.join(root, "packages"))
+
+    ids = [f"bench.mod-{i:05}" for i in range(count)]
+    for i, id in enumerate(ids):
+        info = {
+            "geode": geode,
+            "id": id,
+            "name": sentence(rng, 2),
+            "version": f"1.{rng.randrange(10)}.0",
+            "developer": f"Developer {rng.randrange(count // 10 + 1)}",
+            "description": sentence(rng, 8),
+            "dependencies": [
+                {"id": dep, "version": "1.0.0", "required": True}
+                for dep in sorted(set(rng.sample(ids[:i], min(i, rng.randrange(deps + 1)))))
+            ],
+        }
+        data = package(info, size, rng)
+        filename = f"{id}.geode"
+        with open(os.path.join(root, "packages", filename), "wb") as f:
+            f.write(data)
+
+        folder = os.path.join(root, "index", id)
+        os.makedirs(folder)
+        with open(os.path.join(folder, "mod.json"), "w") as f:
+            json.dump(info, f, indent=4)
+        with open(os.path.join(folder, "about.md"), "w") as f:
+            f.write(f"# {info['name']}\n\n")
+            for _ in range(rng.randrange(1, 6)):
+                f.write(sentence(rng, rng.randrange(20, 80)) + ".\n\n")
+        with open(os.path.join(folder, "index.json"), "w") as f:
+            json.dump({
+                "download": {
+                    "url": f"{url}/packages/{filename}",
+                    "name": filename,
+                    "hash": hashlib.sha3_256(data).hexdigest(),
+                    "platforms": PLATFORMS,
+                },
+                "categories": rng.sample(CATEGORIES, rng.randrange(1, 3)),
+            }, f, indent=4)
+
+    with open(os.path.join(root, "geode.json"), "w") as f:
+        json.dump({"featured": ids[:: max(1, count // 10)]}, f, indent=4)
+
+
+def loader_version():
+    try:
+        path = os.path.join(os.path.dirname(__file__), "..", "..", "..", "VERSION")
+        with open(path) as f:
+            return f.read().strip()
+    except OSError:
+        return "0.0.0"
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(description=__doc__.strip().splitlines()[0])
+    parser.add_argument("root", help="where to generate the index (replaced if it exists)")
+    parser.add_argument("--count", type=int, default=500, help="number of mods")
+    parser.add_argument("--deps", type=int, default=3, help="most dependencies per mod")
+    parser.add_argument("--size", type=int, default=64, help="package payload size in KB")
+    parser.add_argument("--url", default="http://localhost:8000", help="where serve.py runs")
+    parser.add_argument("--geode", default=loader_version(), help="loader version to target")
+    parser.add_argument("--seed", type=int, default=0)
+    args = parser.parse_args()
+    generate(args.root, args.count, args.deps, args.size << 10, args.url, args.geode, args.seed)
+    print(f"Generated {args.count} mods in {args.root}")
@@ -0,0 +1,150 @@
+#!/usr/bin/env python3
+"""
+Serves a local checkout of the mods index the way GitHub does, for testing
+index updates without hitting the real thing. Point the loader at it with
+the "index-source" IPC message:
+
+    {
+        "commit-url": "http://localhost:8000/commit",
+        "snapshot-url": "http://localhost:8000/zipball",
+        "file-url": "http://localhost:8000/raw/{0}/{1}"
+    }
+
+The commit SHA is derived from the contents of the index, so editing any
+file in it looks like a new commit to the loader. manifest.json is
+generated on the fly in the format the loader expects the index to publish.
+
+Mod packages under packages/ (see generate.py) are served from /packages/,
+with support for resuming downloads. --delay adds latency to every request
+to get closer to what installing over the internet is like
+"""
+
+import argparse
+import hashlib
+import io
+import json
+import os
+import re
+import time
+import zipfile
+from http.server import BaseHTTPRequestHandler, ThreadingHTTPServer
+
+ROOT = "."
+DELAY = 0
+SERVED_BYTES = 0
+
+
+def sha256(path):
+    h = hashlib.sha256()
+    with open(path, "rb") as f:
+        for chunk in iter(lambda: f.read(1 << 16), b""):
+            h.update(chunk)
+    return h.hexdigest()
+
+
+def entry_files(folder):
+    for dirpath, _, filenames in os.walk(folder):
+        for name in filenames:
+            yield os.path.relpath(os.path.join(dirpath, name), folder).replace(os.sep, "/")
+
+
+def manifest():
+    entries = {}
+    index = os.path.join(ROOT, "index")
+    for folder in sorted(os.listdir(index)):
+        path = os.path.join(index, folder)
+        if not os.path.isdir(path):
+            continue
+        files = sorted(entry_files(path))
+        h = hashlib.sha256()
+        for file in files:
+            h.update(file.encode())
+            h.update(sha256(os.path.join(path, file)).encode())
+        entries[folder] = {"hash": h.hexdigest(), "files": files}
+    settings = os.path.join(ROOT, "geode.json")
+    return {
+        "geode.json": sha256(settings) if os.path.exists(settings) else "",
+        "entries": entries,
+    }
+
+
+def commit(data):
+    return hashlib.sha1(json.dumps(data, sort_keys=True).encode()).hexdigest()
+
+
+def zipball():
+    buffer = io.BytesIO()
+    with zipfile.ZipFile(buffer, "w", zipfile.ZIP_DEFLATED) as zip:
+        for dirpath, _, filenames in os.walk(ROOT):
+            for name in filenames:
+                path = os.path.join(dirpath, name)
+                rel = os.path.relpath(path, ROOT).replace(os.sep, "/")
+                if rel == "geode.json" or rel.startswith("index/"):
+                    zip.write(path, rel)
+    return buffer.getvalue()
+
+
+class Handler(BaseHTTPRequestHandler):
+    def reply(self, status, body=b"", headers={}):
+        global SERVED_BYTES
+        SERVED_BYTES += len(body)
+        self.send_response(status)
+        self.send_header("Content-Length", str(len(body)))
+        for key, value in headers.items():
+            self.send_header(key, value)
+        self.end_headers()
+        self.wfile.write(body)
+
+    def file(self, path):
+        if not os.path.commonpath([os.path.abspath(path), os.path.abspath(ROOT)]) == \
+                os.path.abspath(ROOT) or not os.path.isfile(path):
+            return self.reply(404)
+        with open(path, "rb") as f:
+            data = f.read()
+        match = re.fullmatch(r"bytes=(\d+)-", self.headers.get("Range", ""))
+        if match:
+            start = int(match.group(1))
+            if start >= len(data):
+                return self.reply(416, headers={"Content-Range": f"bytes */{len(data)}"})
+            return self.reply(206, data[start:], {
+                "Content-Range": f"bytes {start}-{len(data) - 1}/{len(data)}",
+            })
+        return self.reply(200, data)
+
+    def do_GET(self):
+        time.sleep(DELAY / 1000)
+
+        if self.path == "/commit":
+            sha = commit(manifest())
+            if self.headers.get("If-None-Match", "").strip('"') == sha:
+                return self.reply(304)
+            return self.reply(200, sha.encode(), {"ETag": f'"{sha}"'})
+
+        if self.path == "/zipball":
+            return self.reply(200, zipball(), {"Content-Type": "application/zip"})
+
+        if self.path.startswith("/raw/"):
+            # the commit is ignored, only the current state is ever served
+            _, _, _, rel = self.path.split("/", 3)
+            if rel == "manifest.json":
+                return self.reply(200, json.dumps(manifest()).encode())
+            return self.file(os.path.normpath(os.path.join(ROOT, rel)))
+
+        if self.path.startswith("/packages/"):
+            return self.file(os.path.normpath(os.path.join(ROOT, self.path[1:])))
+
+        self.reply(404)
+
+    def log_message(self, format, *args):
+        print(f"{self.address_string()} {format % args} (total {SERVED_BYTES} bytes served)")
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(description=__doc__.strip().splitlines()[0])
+    parser.add_argument("root", help="checkout of the index, containing geode.json and index/")
+    parser.add_argument("--port", type=int, default=8000)
+    parser.add_argument("--delay", type=int, default=0, help="latency to add in milliseconds")
+    args = parser.parse_args()
+    ROOT = args.root
+    DELAY = args.delay
+    ThreadingHTTPServer(("", args.port), Handler).serve_forever()
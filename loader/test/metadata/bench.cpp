@@ -0,0 +1,369 @@
+// Measures the allocations and memory node metadata takes for populations
+// of nodes, like the objects of a level in the editor. Built as
+// GeodeMetadataBench with the other tests, or on its own without the SDK:
+//
+//     c++ -std=c++20 -O2 -I../../src/internal bench.cpp ../../src/internal/SlabPool.cpp
+//
+// The loader can't be linked outside of the game, so the metadata is modeled
+// with the members of GeodeNodeMetadata and FieldContainer (CCObject is a
+// block of its size). "before" is the layout with a heap-allocated field
+// container, a string ID and a string map of attributes; "after" is the one
+// in loader/src/hooks/GeodeNodeMetadata.cpp and Geode/modify/Field.hpp
+
+#include <SlabPool.hpp>
+
+#include <any>
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <new>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+static size_t s_allocations = 0;
+static size_t s_liveBytes = 0;
+
+// every allocation remembers its size in front of it, to count the bytes
+// that are still allocated
+void* operator new(size_t size) {
+    auto block = static_cast<size_t*>(std::malloc(size + alignof(std::max_align_t)));
+    if (!block) throw std::bad_alloc();
+    s_allocations++;
+    s_liveBytes += size;
+    *block = size;
+    return reinterpret_cast<std::byte*>(block) + alignof(std::max_align_t);
+}
+
+void operator delete(void* ptr) noexcept {
+    if (!ptr) return;
+    auto block = reinterpret_cast<size_t*>(static_cast<std::byte*>(ptr) - alignof(std::max_align_t));
+    s_liveBytes -= *block;
+    std::free(block);
+}
+
+void operator delete(void* ptr, size_t) noexcept {
+    operator delete(ptr);
+}
+
+// the size of CCObject on 64-bit
+using ObjectBase = std::array<std::byte, 56>;
+
+struct Fields {
+    float m_speed = 1.f;
+    int m_group = 0;
+    bool m_selected = false;
+    std::array<char, 12> m_tag {};
+};
+
+static void destroyFields(void* fields) {
+    static_cast<Fields*>(fields)->~Fields();
+}
+
+namespace before {
+    class FieldContainer {
+        std::vector<void*> m_containedFields;
+        std::vector<std::function<void(void*)>> m_destructorFunctions;
+
+    public:
+        ~FieldContainer() {
+            for (auto i = 0u; i < m_containedFields.size(); i++) {
+                if (m_containedFields[i]) {
+                    m_destructorFunctions[i](m_containedFields[i]);
+                }
+                operator delete(m_containedFields[i]);
+            }
+        }
+
+        void* getField(size_t index) {
+            if (m_containedFields.size() <= index) {
+                m_containedFields.resize(index + 1);
+                m_destructorFunctions.resize(index + 1);
+            }
+            return m_containedFields.at(index);
+        }
+
+        void* setField(size_t index, size_t size, std::function<void(void*)> destructor) {
+            m_containedFields.at(index) = operator new(size);
+            m_destructorFunctions.at(index) = destructor;
+            return m_containedFields.at(index);
+        }
+    };
+
+    struct Metadata {
+        ObjectBase m_object;
+        FieldContainer* m_fieldContainer = new FieldContainer();
+        void* m_userObject = nullptr;
+        std::string m_id;
+        std::unique_ptr<int> m_layout;
+        int m_positionHint = 0;
+        std::unordered_map<std::string, std::any> m_attributes;
+
+        ~Metadata() {
+            delete m_fieldContainer;
+        }
+
+        void setID(std::string const& id) {
+            m_id = id;
+        }
+
+        void addFields(size_t index) {
+            if (!m_fieldContainer->getField(index)) {
+                new (m_fieldContainer->setField(index, sizeof(Fields), &destroyFields)) Fields();
+            }
+        }
+
+        void setAttribute(std::string const& name, std::any value) {
+            m_attributes[name] = value;
+        }
+    };
+}
+
+namespace after {
+    static std::unordered_set<std::string> s_interned;
+
+    static std::string const* intern(std::string const& str) {
+        if (str.empty()) return nullptr;
+        return &*s_interned.insert(str).first;
+    }
+
+    static std::array<SlabPool*, 4> const& fieldPools() {
+        static auto pools = [] {
+            std::array<SlabPool*, 4> ret;
+            for (size_t i = 0; i < ret.size(); i++) {
+                ret[i] = new SlabPool(32 << i);
+            }
+            return ret;
+        }();
+        return pools;
+    }
+
+    static SlabPool* fieldPool(size_t size) {
+        for (auto pool : fieldPools()) {
+            if (size <= pool->blockSize()) {
+                return pool;
+            }
+        }
+        return nullptr;
+    }
+
+    class FieldContainer {
+    private:
+        // in front of the data of every field. the fields of a node are a
+        // list, most recently added first
+        struct alignas(std::max_align_t) Field {
+            Field* m_next;
+            size_t m_index;
+            // size of the data after the header, aligned
+            size_t m_size;
+            void (*m_destructor)(void*);
+            // the mod whose code m_destructor is in
+            void* m_owner;
+
+            void* data() {
+                return this + 1;
+            }
+        };
+
+        // the fields of most nodes fit in here, so they're stored along with
+        // the rest of the node's metadata without allocating
+        static constexpr size_t INLINE_SIZE = 80;
+        alignas(std::max_align_t) std::byte m_inline[INLINE_SIZE];
+        size_t m_inlineUsed = 0;
+        Field* m_fields = nullptr;
+
+        bool isInline(Field* field) const {
+            auto bytes = reinterpret_cast<std::byte const*>(field);
+            return bytes >= m_inline && bytes < m_inline + INLINE_SIZE;
+        }
+
+        void destroy(Field* field) {
+            field->m_destructor(field->data());
+            if (!this->isInline(field)) {
+                fieldPool(sizeof(Field) + field->m_size)->deallocate(field);
+            }
+        }
+
+    public:
+        FieldContainer() = default;
+        FieldContainer(FieldContainer const&) = delete;
+        FieldContainer& operator=(FieldContainer const&) = delete;
+
+        ~FieldContainer() {
+            auto field = m_fields;
+            while (field) {
+                auto next = field->m_next;
+                this->destroy(field);
+                field = next;
+            }
+        }
+
+        void* getField(size_t index) {
+            // nodes only have the fields of a few classes, so this is faster
+            // than a map
+            for (auto field = m_fields; field; field = field->m_next) {
+                if (field->m_index == index) {
+                    return field->data();
+                }
+            }
+            return nullptr;
+        }
+
+        void* setField(size_t index, size_t size, void (*destructor)(void*), void* owner) {
+            // keep every field aligned for any type, like operator new would
+            auto aligned = (size + alignof(std::max_align_t) - 1) & ~(alignof(std::max_align_t) - 1);
+            auto total = sizeof(Field) + aligned;
+
+            void* block;
+            if (m_inlineUsed + total <= INLINE_SIZE) {
+                block = m_inline + m_inlineUsed;
+                m_inlineUsed += total;
+            }
+            else {
+                block = fieldPool(total)->allocate();
+            }
+            m_fields = new (block) Field { m_fields, index, aligned, destructor, owner };
+            return m_fields->data();
+        }
+    };
+
+    struct Metadata {
+        ObjectBase m_object;
+        FieldContainer m_fieldContainer;
+        void* m_userObject = nullptr;
+        std::string const* m_id = nullptr;
+        std::unique_ptr<int> m_layout;
+        int m_positionHint = 0;
+        std::vector<std::pair<std::string const*, std::any>> m_attributes;
+        std::unique_ptr<int> m_indexes;
+
+        static SlabPool& pool() {
+            static auto pool = new SlabPool(sizeof(Metadata));
+            return *pool;
+        }
+
+        static void* operator new(size_t) {
+            return pool().allocate();
+        }
+
+        static void operator delete(void* block) {
+            pool().deallocate(block);
+        }
+
+        void setID(std::string const& id) {
+            m_id = intern(id);
+        }
+
+        void addFields(size_t index) {
+            if (!m_fieldContainer.getField(index)) {
+                static int mod;
+                new (m_fieldContainer.setField(index, sizeof(Fields), &destroyFields, &mod))
+                    Fields();
+            }
+        }
+
+        void setAttribute(std::string const& name, std::any value) {
+            auto key = intern(name);
+            for (auto& [k, v] : m_attributes) {
+                if (k == key) {
+                    v = std::move(value);
+                    return;
+                }
+            }
+            m_attributes.emplace_back(key, std::move(value));
+        }
+    };
+}
+
+struct Population {
+    char const* m_name;
+    bool m_fields;
+    bool m_attribute;
+};
+
+// bytes of pool blocks in use, and bytes reserved by the pools
+static std::pair<size_t, size_t> poolBytes() {
+    std::pair<size_t, size_t> ret;
+    auto add = [&](SlabPool const& pool) {
+        ret.first += pool.live() * pool.blockSize();
+        ret.second += pool.reserved();
+    };
+    add(after::Metadata::pool());
+    for (auto pool : after::fieldPools()) {
+        add(*pool);
+    }
+    return ret;
+}
+
+template <class Metadata>
+static void measure(char const* layout, Population const& population, size_t count) {
+    // objects of a level share a few hundred IDs
+    std::vector<std::string> ids;
+    for (size_t i = 0; i < 300; i++) {
+        ids.push_back("editor-object-" + std::to_string(i));
+    }
+    static std::string const attribute = "selection-group";
+    std::vector<Metadata*> nodes;
+    nodes.reserve(count);
+
+    auto const allocations = s_allocations;
+    auto const liveBytes = s_liveBytes;
+    auto const [poolUsed, poolReserved] = poolBytes();
+    auto const start = std::chrono::steady_clock::now();
+
+    for (size_t i = 0; i < count; i++) {
+        auto meta = new Metadata();
+        meta->setID(ids[i % ids.size()]);
+        if (population.m_fields) {
+            meta->addFields(0);
+        }
+        if (population.m_attribute) {
+            meta->setAttribute(attribute, static_cast<int>(i % 16));
+        }
+        nodes.push_back(meta);
+    }
+    auto const created = std::chrono::steady_clock::now();
+
+    // the blocks taken from the pools count as memory in use, the chunks
+    // they come from only as far as they're used
+    auto const [poolUsedNow, poolReservedNow] = poolBytes();
+    auto const allocationCount = s_allocations - allocations;
+    auto const bytes = (s_liveBytes - liveBytes) - (poolReservedNow - poolReserved) +
+        (poolUsedNow - poolUsed);
+
+    for (auto meta : nodes) {
+        delete meta;
+    }
+    auto const destroyed = std::chrono::steady_clock::now();
+
+    using ms = std::chrono::duration<double, std::milli>;
+    std::printf(
+        "%6s %-22s %6zu nodes: %6zu allocations (%4.2f per node), %5.0f bytes per node, "
+        "create %6.2f ms, destroy %6.2f ms\n",
+        layout, population.m_name, count, allocationCount,
+        static_cast<double>(allocationCount) / count, static_cast<double>(bytes) / count,
+        ms(created - start).count(), ms(destroyed - created).count()
+    );
+}
+
+int main() {
+    Population const populations[] = {
+        { "ID", false, false },
+        { "ID, fields", true, false },
+        { "ID, fields, attribute", true, true },
+    };
+    for (auto count : { 10000, 100000 }) {
+        for (auto& population : populations) {
+            measure<before::Metadata>("before", population, count);
+            measure<after::Metadata>("after", population, count);
+        }
+    }
+    std::printf(
+        "\nafter: %zu byte metadata blocks, %zu bytes reserved by the pools\n",
+        after::Metadata::pool().blockSize(), poolBytes().second
+    );
+}
@@ -0,0 +1,237 @@
+#include <Geode/Loader.hpp>
+#include <Geode/modify/MenuLayer.hpp>
+
+#include <chrono>
+#include <random>
+
+USE_GEODE_NAMESPACE();
+
+// Times getChildByID and getChildByIDRecursive on a generated tree against
+// walking the tree and comparing strings, which is what they used to do.
+// Every lookup is also checked against the walk, including after the tree
+// changes in the ways that have to invalidate the indexes
+
+static constexpr int BRANCHING = 10;
+static constexpr int DEPTH = 4;
+static constexpr int LOOKUPS = 1000;
+
+static int s_nodeCount = 0;
+
+static CCNode* createTree(int depth) {
+    auto node = CCNode::create();
+    node->setID(fmt::format("node-{}", s_nodeCount++));
+    if (depth < DEPTH) {
+        for (int i = 0; i < BRANCHING; i++) {
+            node->addChild(createTree(depth + 1));
+        }
+    }
+    return node;
+}
+
+static CCNode* walk(CCNode* node, std::string const& id) {
+    for (auto child : CCArrayExt<CCNode>(node->getChildren())) {
+        if (child->getID() == id) {
+            return child;
+        }
+    }
+    for (auto child : CCArrayExt<CCNode>(node->getChildren())) {
+        if (auto found = walk(child, id)) {
+            return found;
+        }
+    }
+    return nullptr;
+}
+
+static CCNode* walkChildren(CCNode* node, std::string const& id) {
+    for (auto child : CCArrayExt<CCNode>(node->getChildren())) {
+        if (child->getID() == id) {
+            return child;
+        }
+    }
+    return nullptr;
+}
+
+static size_t s_checks = 0;
+static size_t s_mismatches = 0;
+
+// look up the ID both ways under the node and compare to walking the tree
+static void check(char const* when, CCNode* node, std::string const& id) {
+    s_checks += 1;
+    auto expected = walk(node, id);
+    auto found = node->getChildByIDRecursive(id);
+    if (found != expected) {
+        s_mismatches += 1;
+        log::error(
+            "{}: getChildByIDRecursive(\"{}\") under {} found {}, walking found {}", when, id,
+            node->getID(), fmt::ptr(found), fmt::ptr(expected)
+        );
+    }
+    auto expectedChild = walkChildren(node, id);
+    auto foundChild = node->getChildByID(id);
+    if (foundChild != expectedChild) {
+        s_mismatches += 1;
+        log::error(
+            "{}: getChildByID(\"{}\") under {} found {}, walking found {}", when, id,
+            node->getID(), fmt::ptr(foundChild), fmt::ptr(expectedChild)
+        );
+    }
+}
+
+static CCNode* childAt(CCNode* node, unsigned int index) {
+    return static_cast<CCNode*>(node->getChildren()->objectAtIndex(index));
+}
+
+// changes the tree in every way that has to reach the indexes, checking
+// the lookups on the root and on the changed nodes' parents after each
+static void checkChanges(CCNode* root) {
+    // kept alive by these, as some of them are removed along the way
+    Ref<CCNode> first = childAt(root, 0);
+    Ref<CCNode> second = childAt(root, 1);
+    Ref<CCNode> last = static_cast<CCNode*>(root->getChildren()->lastObject());
+    Ref<CCNode> deep = childAt(childAt(first, 0), 0);
+    Ref<CCNode> deepParent = deep->getParent();
+    auto checkAll = [&](char const* when, std::string const& id) {
+        for (CCNode* node : { root, *first, *second, *last, *deepParent }) {
+            check(when, node, id);
+        }
+    };
+
+    // a node deep in the first branch and a child of the root share an ID,
+    // which finds the child, as all the children are searched first. the
+    // lookups before changing anything build the indexes
+    checkAll("before changing anything", deep->getID());
+    deep->setID("duplicate");
+    checkAll("one node with the ID", "duplicate");
+    last->setID("duplicate");
+    checkAll("duplicate IDs", "duplicate");
+    // and siblings sharing one find the first of them
+    childAt(second, 1)->setID("sibling");
+    childAt(second, 3)->setID("sibling");
+    checkAll("duplicate sibling IDs", "sibling");
+    childAt(second, 1)->setID("sibling-renamed");
+    checkAll("renaming a duplicate", "sibling");
+    checkAll("renaming a duplicate", "sibling-renamed");
+
+    // changing the ID of an indexed node
+    auto renamed = childAt(childAt(second, 2), 4);
+    auto const oldID = renamed->getID();
+    check("before renaming", root, oldID);
+    renamed->setID("renamed");
+    checkAll("after renaming", oldID);
+    checkAll("after renaming", "renamed");
+    renamed->setID("");
+    checkAll("after clearing the ID", "renamed");
+
+    // moving a node (and everything under it) to another branch
+    Ref<CCNode> moved = childAt(first, 5);
+    auto const movedID = moved->getID();
+    auto const movedChildID = childAt(moved, 0)->getID();
+    auto oldParent = moved->getParent();
+    check("before moving", root, movedID);
+    check("before moving", first, movedChildID);
+    oldParent->removeChild(moved);
+    checkAll("after removing", movedID);
+    checkAll("after removing", movedChildID);
+    check("after removing", oldParent, movedID);
+    childAt(second, 0)->addChild(moved);
+    checkAll("after moving", movedID);
+    checkAll("after moving", movedChildID);
+    check("after moving", childAt(second, 0), movedID);
+    check("after moving", oldParent, movedID);
+
+    // moving a node with a duplicate ID ahead of the other one
+    deepParent->removeChild(deep);
+    root->addChild(deep);
+    checkAll("after moving a duplicate", "duplicate");
+    root->removeChild(last);
+    checkAll("after removing a duplicate", "duplicate");
+    root->removeAllChildrenWithCleanup(true);
+    checkAll("after removing every child", "duplicate");
+}
+
+template <class F>
+static double time(F&& func) {
+    auto start = std::chrono::steady_clock::now();
+    func();
+    return std::chrono::duration<double, std::micro>(
+        std::chrono::steady_clock::now() - start
+    ).count();
+}
+
+static void benchmark() {
+    s_nodeCount = 0;
+    Ref<CCNode> root = createTree(0);
+
+    std::mt19937 rng(0);
+    std::vector<std::string> ids;
+    for (int i = 0; i < LOOKUPS; i++) {
+        ids.push_back(fmt::format("node-{}", 1 + rng() % (s_nodeCount - 1)));
+    }
+    std::vector<std::string> childIDs;
+    for (auto child : CCArrayExt<CCNode>(root->getChildren())) {
+        childIDs.push_back(child->getID());
+    }
+    auto last = static_cast<CCNode*>(root->getChildren()->lastObject());
+
+    s_checks = 0;
+    s_mismatches = 0;
+    for (auto& id : ids) {
+        check("lookup", root, id);
+    }
+    check("lookup", root, "missing");
+    for (auto& id : childIDs) {
+        check("lookup", root, id);
+    }
+
+    size_t found = 0;
+    auto const walked = time([&] {
+        for (auto& id : ids) found += walk(root, id) != nullptr;
+    });
+    auto const built = time([&] {
+        found += root->getChildByIDRecursive(ids.front()) != nullptr;
+    });
+    auto const indexed = time([&] {
+        for (auto& id : ids) found += root->getChildByIDRecursive(id) != nullptr;
+    });
+    auto const missed = time([&] {
+        for (int i = 0; i < LOOKUPS; i++) found += root->getChildByIDRecursive("missing") != nullptr;
+    });
+    auto const direct = time([&] {
+        for (int i = 0; i < LOOKUPS; i++) {
+            found += root->getChildByID(childIDs[i % childIDs.size()]) != nullptr;
+        }
+    });
+    // every change invalidates the index, so this is a rebuild per lookup
+    auto const changed = time([&] {
+        for (int i = 0; i < LOOKUPS / 10; i++) {
+            last->setID(fmt::format("moved-{}", i));
+            found += root->getChildByIDRecursive(ids[i]) != nullptr;
+        }
+    });
+    for (int i = 0; i < LOOKUPS / 10; i++) {
+        check("after changing an ID", root, ids[i]);
+    }
+    checkChanges(root);
+
+    log::info(
+        "{} nodes, {} lookups ({} found): walking {:.0f} us, building the index {:.0f} us, "
+        "indexed {:.0f} us, missing ID {:.0f} us, direct children {:.0f} us, "
+        "{} lookups after changing an ID {:.0f} us; {} lookups checked against walking, "
+        "{} mismatched ({})",
+        s_nodeCount, LOOKUPS, found, walked, built, indexed, missed, direct,
+        LOOKUPS / 10, changed, s_checks, s_mismatches, s_mismatches ? "failed" : "passed"
+    );
+}
+
+struct BenchMenuLayer : Modify<BenchMenuLayer, MenuLayer> {
+    bool init() {
+        if (!MenuLayer::init()) return false;
+
+        static bool ran = false;
+        if (!ran) {
+            ran = true;
+            benchmark();
+        }
+        return true;
+    }
+};